@@ -13,8 +13,9 @@
 
 #include "genlib.h"
 #include "cmpfn.h"
-#include "stack.h"
 #include "foreach.h"
+#include "nodepool.h"
+#include "instrument.h"
 
 /*
  * Class: BST
@@ -26,9 +27,16 @@
  * The one requirement on the element type is that the client must
  * supply a comparison fn that compares two elements (or be willing
  * to use the default comparison function that relies on < and ==).
+ *
+ * The optional second template argument is the comparator class,
+ * described in cmpfn.h.  The default, FunctionComparator, calls a
+ * comparison function through a pointer.  For types with a natural
+ * ordering, BST<string, OperatorComparator<string> > lets the compiler
+ * expand the comparisons inline and avoids copying the keys.
  */
 
-template <typename ElemType>
+template <typename ElemType,
+          typename Comparator = FunctionComparator<ElemType> >
 class BST {
 public:
 
@@ -48,8 +56,21 @@ public:
  * applies the built-in operator < to its operands. If the
  * behavior of < on your ElemType is defined and sufficient,
  * you do not need to supply your own comparison function.
+ * If the tree uses a comparator class other than the default,
+ * the argument is an object of that class.
+ */
+	BST(Comparator cmpFn = Comparator());
+
+/*
+ * Constructor: BST
+ * Usage: BST<string> bst(OperatorCmp, pool);
+ * ------------------------------------------
+ * This constructor initializes a new empty tree that allocates its
+ * nodes from the specified NodePool instead of from a pool of its
+ * own.  Trees of the same type can share one pool, which must
+ * outlive all of them.
  */
-	BST(int (*cmpFn)(ElemType one, ElemType two) = OperatorCmp);
+	BST(Comparator cmpFn, NodePool & pool);
 
 /*
  * Destructor: ~BST
@@ -87,7 +108,7 @@ public:
  * in the tree, find returns a pointer to the data in that node;
  * otherwise, find returns NULL.
  */
-	ElemType *find(ElemType key);
+	ElemType *find(const ElemType & key);
 
 /*
  * Method: add
@@ -100,7 +121,7 @@ public:
  * false is returned.  If no matching node is found, a new node
  * is allocated and added to the tree, true is returned.
  */
-	bool add(ElemType elem);
+	bool add(const ElemType & elem);
 
 /*
  * Method: remove
@@ -111,7 +132,7 @@ public:
  * is removed from the tree and true is returned. If no match
  * is found, no changes are made and false is returned.
  */
-	bool remove(ElemType key);
+	bool remove(const ElemType & key);
 
 /*
  * Method: clear
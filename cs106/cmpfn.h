@@ -2,12 +2,15 @@
  * File: cmpfn.h
  * Last modified on Wed Sep 18 14:38:14 2002 by zelenski
  * -----------------------------------------------------
- * This interface exports a comparison function template.
+ * This interface exports a comparison function template and the
+ * comparator classes used by the ordered collections.
  */
 
 #ifndef _cmpfn_h
 #define _cmpfn_h
 
+#include <cstddef>
+
 /*
  * Function template: OperatorCmp
  * Usage:  int sign = OperatorCmp(val1, val2);
@@ -25,4 +28,94 @@ int OperatorCmp(Type one, Type two) {
 	return 1;
 }
 
+/*
+ * Class template: FunctionComparator
+ * Usage: FunctionComparator<int> cmp(CompareInts);
+ *        int sign = cmp(val1, val2);
+ * -----------------------------------------------
+ * This class template packages a comparison function as an object
+ * that the ordered collection classes can call.  It is the default
+ * comparator for BST and Set, which makes those classes behave just
+ * as they always have: the comparison is called through a function
+ * pointer, which defaults to OperatorCmp.  A function pointer converts
+ * automatically to a FunctionComparator, so existing code such as
+ *
+ *     Set<studentT> students(CompareStudentsById);
+ *
+ * continues to work unchanged.  Two FunctionComparator objects are
+ * equal if they hold the same function.  When no function is given,
+ * the values are compared by reference with the same operators as
+ * OperatorCmp, so that values such as strings are not copied.
+ */
+
+template <typename Type>
+class FunctionComparator {
+public:
+	FunctionComparator() {
+		fn = OperatorCmp;
+		refFn = operatorCmpByRef;
+	}
+
+	FunctionComparator(int (*cmpFn)(Type, Type)) {
+		fn = cmpFn;
+		refFn = NULL;
+	}
+
+	int operator()(const Type & one, const Type & two) const {
+		if (refFn != NULL) return refFn(one, two);
+		return fn(one, two);
+	}
+
+	bool operator==(const FunctionComparator & other) const {
+		return fn == other.fn;
+	}
+
+	bool operator!=(const FunctionComparator & other) const {
+		return fn != other.fn;
+	}
+
+private:
+	int (*fn)(Type, Type);
+	int (*refFn)(const Type &, const Type &);
+
+	static int operatorCmpByRef(const Type & one, const Type & two) {
+		if (one == two) return 0;
+		if (one < two) return -1;
+		return 1;
+	}
+};
+
+/*
+ * Class template: OperatorComparator
+ * Usage: Set<string, OperatorComparator<string> > words;
+ * ------------------------------------------------------
+ * This class template compares two values using the built-in == and <
+ * operators, in the same way as OperatorCmp.  Because the comparison
+ * is a member of the class rather than a function pointer, the
+ * compiler can expand it inline, and the arguments are passed by
+ * reference so that values such as strings are not copied.  Using
+ * OperatorComparator as the comparator argument of BST, Set or FlatSet
+ * makes the searches in those classes noticeably faster for types
+ * that have a natural ordering.  All OperatorComparator objects are
+ * equal to one another.
+ */
+
+template <typename Type>
+class OperatorComparator {
+public:
+	int operator()(const Type & one, const Type & two) const {
+		if (one == two) return 0;
+		if (one < two) return -1;
+		return 1;
+	}
+
+	bool operator==(const OperatorComparator &) const {
+		return true;
+	}
+
+	bool operator!=(const OperatorComparator &) const {
+		return false;
+	}
+};
+
 #endif
@@ -0,0 +1,251 @@
+/*
+ * File: flatset.h
+ * -----------------------------------------------------
+ * This interface file contains the FlatSet class template, a set
+ * of distinct elements stored in a sorted array.
+ */
+
+#ifndef _flatset_h
+#define _flatset_h
+
+#include "genlib.h"
+#include "cmpfn.h"
+#include "vector.h"
+#include "foreach.h"
+#include "instrument.h"
+#include <algorithm>
+
+/*
+ * Class: FlatSet
+ * --------------
+ * This interface defines a class template that stores a collection of
+ * distinct elements in the same way as Set, but keeps them in a single
+ * sorted array instead of a tree.  The array makes lookups quick and
+ * the set small, and the set operations (unionWith, intersectWith,
+ * subtract, isSubsetOf and equals) run in linear time by walking both
+ * sets in order.  The tradeoff is that adding or removing a single
+ * element takes time proportional to the size of the set, so a FlatSet
+ * is best built all at once, with addAll or the array constructor, and
+ * then mostly read.
+ *
+ * As with Set, the client must supply a comparison function that
+ * compares two elements, or be willing to use the default comparison
+ * function that uses the built-in operators < and ==.  The optional
+ * second template argument selects the comparator class, exactly as
+ * it does for Set.
+ */
+
+template <typename ElemType,
+          typename Comparator = FunctionComparator<ElemType> >
+class FlatSet {
+
+public:
+
+/* Forward references */
+	class Iterator;
+
+/*
+ * Constructor: FlatSet
+ * Usage: FlatSet<int> set;
+ *        FlatSet<student> students(CompareStudentsById);
+ *        FlatSet<string> *sp = new FlatSet<string>;
+ * -------------------------------------------------
+ * The constructor initializes an empty set. The optional argument
+ * is a comparison function with the same meaning as for Set.  If
+ * no argument is supplied, the OperatorCmp template is used.
+ */
+	FlatSet(Comparator cmpFn = Comparator());
+
+/*
+ * Constructor: FlatSet
+ * Usage: FlatSet<int> set(array, n);
+ * ----------------------------------
+ * This constructor initializes a set holding the first n elements of
+ * the array, which need not be sorted and may contain duplicates.
+ * This is the same as constructing an empty set and calling addAll,
+ * and takes O(N log N) time.
+ */
+	FlatSet(const ElemType array[], int n, Comparator cmpFn = Comparator());
+
+/*
+ * Destructor: ~FlatSet
+ * Usage: delete sp;
+ * -----------------
+ * The destructor deallocates storage associated with set.
+ */
+	~FlatSet();
+
+/*
+ * Method: size
+ * Usage: count = set.size();
+ * --------------------------
+ * This method returns the number of elements in this set.
+ */
+	int size();
+
+/*
+ * Method: isEmpty
+ * Usage: if (set.isEmpty())...
+ * ----------------------------
+ * This method returns true if this set contains no
+ * elements, false otherwise.
+ */
+	bool isEmpty();
+
+/*
+ * Method: add
+ * Usage: set.add(value);
+ * ----------------------
+ * This method adds an element to this set. If the value was already
+ * contained in the set, the existing entry is overwritten by the new
+ * copy, and the set's size is unchanged.  Because the elements after
+ * the new one must be shifted over, a single add takes O(N) time;
+ * use addAll to add many elements at once.
+ */
+	void add(const ElemType & elem);
+
+/*
+ * Method: addAll
+ * Usage: set.addAll(array, n);
+ *        set.addAll(vec);
+ * ---------------------------
+ * This method adds all of the given elements to this set, which need
+ * not be sorted and may contain duplicates.  As with add, a later copy
+ * of an element overwrites an earlier one.  The new elements are
+ * sorted and then merged with the existing ones, so the whole
+ * operation takes O(N log N) time in the number of new elements plus
+ * O(N) time in the size of the set.
+ */
+	void addAll(const ElemType array[], int n);
+	void addAll(Vector<ElemType> & elems);
+
+/*
+ * Method: remove
+ * Usage: set.remove(value);
+ * -----------------------
+ * This method removes an element from this set. If the
+ * element was not contained in the set, the set is unchanged.
+ */
+	void remove(const ElemType & elem);
+
+/*
+ * Method: contains
+ * Usage: if (set.contains(value))...
+ * -----------------------------------
+ * Returns true if the element in this set, false otherwise.
+ */
+	bool contains(const ElemType & elem);
+
+/*
+ * Method: find
+ * Usage: eptr = set.find(elem);
+ * -----------------------------
+ * If the element is contained in this set, returns a pointer to that
+ * element, which allows you to update it in place as long as its
+ * position in the ordering does not change.  The pointer is valid
+ * only until the set is next modified.  If the element is not
+ * contained in this set, NULL is returned.
+ */
+	ElemType *find(const ElemType & elem);
+
+/*
+ * Method: equals
+ * Usage: if (set.equals(set2)) . . .
+ * -----------------------------------
+ * This predicate function implements the equality relation
+ * on sets.  It returns true if this set and set2 contain
+ * exactly the same elements, false otherwise.
+ */
+	bool equals(FlatSet & otherSet);
+
+/*
+ * Method: isSubsetOf
+ * Usage: if (set.isSubsetOf(set2)) . . .
+ * --------------------------------------
+ * This predicate function implements the subset relation
+ * on sets.  It returns true if all of the elements in this
+ * set are contained in set2.  The set2 does not have to
+ * be a proper subset (that is, it may be equals).
+ */
+	bool isSubsetOf(FlatSet & otherSet);
+
+/*
+ * Methods: unionWith, intersectWith, subtract
+ * Usage: set.unionWith(set2);
+ *        set.intersectWith(set2);
+ *        set.subtract(set2);
+ * -------------------------------
+ * These member functions modify the receiver set as follows:
+ *
+ * set.unionWith(set2);      Adds all elements from set2 to this set.
+ * set.intersectWith(set2);  Removes any element not in set2 from this set.
+ * set.subtract(set2);       Removes all element in set2 from this set.
+ *
+ * Each runs in time proportional to the combined size of the sets.
+ */
+	void unionWith(FlatSet & otherSet);
+	void intersectWith(FlatSet & otherSet);
+	void subtract(FlatSet & otherSet);
+
+/*
+ * Method: clear
+ * Usage: set.clear();
+ * -------------------
+ * This method removes all elements from this set. The
+ * set is made empty and will have size() = 0 after being cleared.
+ */
+	void clear();
+
+/*
+ * SPECIAL NOTE: mapping/iteration support
+ * ---------------------------------------
+ * The set supports both a mapping operation and an iterator which
+ * allow the client access to all elements one by one.  In general,
+ * these  are intended for _viewing_ elements and can behave
+ * unpredictably if you attempt to modify the set's contents during
+ * mapping/iteration.
+ */
+
+/*
+ * Method: mapAll
+ * Usage: set.mapAll(Print);
+ * -------------------------
+ * This method iterates through this set's contents
+ * and calls the function fn once for each element.
+ */
+	void mapAll(void (*fn)(ElemType elem));
+
+/*
+ * Method: mapAll
+ * Usage: set.mapAll(PrintToFile, outputStream);
+ * --------------------------------------------
+ * This method iterates through this set's contents
+ * and calls the function fn once for each element, passing
+ * the element and the client's data. That data can be of whatever
+ * type is needed for the client's callback.
+ */
+	template <typename ClientDataType>
+	void mapAll(void (*fn)(ElemType elem, ClientDataType & data),
+	            ClientDataType & data);
+
+/*
+ * Method: iterator
+ * Usage: iter = set.iterator();
+ * -----------------------------
+ * This method creates an iterator that allows the client to
+ * iterate through the elements in this set.  The elements are
+ * returned in the order determined by the comparison function.
+ * The iterator can be used in the same ways as the one for Set,
+ * including in a foreach loop.
+ */
+	Iterator iterator();
+
+private:
+
+#include "private/flatset.h"
+
+};
+
+#include "private/flatset.cpp"
+
+#endif
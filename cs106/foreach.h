@@ -17,6 +17,7 @@
 #include <ios>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
 /* Redefine the ios constants (one of which is "in") */
 
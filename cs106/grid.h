@@ -25,6 +25,10 @@
  * setAt/getAt methods, as well as an overloaded operator[].
  * Either refers to cells by row/col location; indexes start at 0 in
  * each dimension.
+ *
+ * In builds that define NDEBUG, the bounds checks on element access
+ * are compiled out; private/checks.h explains how to control this
+ * with the CS106_CHECKS and GRID_CHECKS macros.
  */
 
 #ifndef _grid_h
@@ -33,6 +37,8 @@
 #include "genlib.h"
 #include "strutils.h"
 #include "foreach.h"
+#include "instrument.h"
+#include "private/checks.h"
 
 /*
  * Class: Grid
@@ -43,6 +49,15 @@
  * with private data members, clients have no access to the underlying
  * data members and can only manipulate a grid object through
  * its public methods.
+ *
+ * A grid normally stores its elements in row-major order.  A grid
+ * created with the TiledLayout option instead stores them in square
+ * tiles of 8 x 8 elements, so that cells that are near each other in
+ * either direction are also near each other in memory.  That makes
+ * walks down columns or over small neighborhoods faster on large
+ * grids.  The layout does not change the results of any method; the
+ * only difference visible to clients is that rowSpan requires the
+ * row-major layout.
  */
 
 template <typename ElemType>
@@ -54,6 +69,14 @@ public:
 	class GridRow;
 	class Iterator;
 
+/*
+ * Type: layoutOptionT
+ * -------------------
+ * This enumerated type selects how the grid arranges its elements
+ * in memory, as described in the comments for the class.
+ */
+	enum layoutOptionT { RowMajorLayout, TiledLayout };
+
 /*
  * Constructor: Grid
  * Usage: Grid<bool> grid;
@@ -77,6 +100,15 @@ public:
  */
 	Grid(int numRows, int numCols);
 
+/*
+ * Constructor: Grid
+ * Usage: Grid<int> heat(1000, 1000, Grid<int>::TiledLayout);
+ * ----------------------------------------------------------
+ * This constructor is the same as the two-argument constructor,
+ * except that it also chooses the memory layout of the grid.
+ */
+	Grid(int numRows, int numCols, layoutOptionT layout);
+
 /*
  * Destructor: ~Grid
  * Usage: delete gp;
@@ -95,17 +127,28 @@ public:
 	int numRows();
 	int numCols();
 
+/*
+ * Method: getLayout
+ * Usage: if (grid.getLayout() == Grid<int>::TiledLayout) . . .
+ * ------------------------------------------------------------
+ * This method returns the memory layout of this grid.
+ */
+	layoutOptionT getLayout();
+
 /*
  * Method: resize
  * Usage: grid.resize(5, 10);
- * --------------------------
+ *        grid.resize(5, 10, true);
+ * --------------------------------
  * This method sets the number of rows and columns in this
  * grid to the specified values. Any previous grid contents are
  * discarded.   Each element in the  resized grid has value equal
  * to the default for that element type. Raises an error if numRows
- * or numCols is negative.
+ * or numCols is negative.  If the optional retainContents argument
+ * is true, the elements in the rows and columns that the old and
+ * new sizes have in common keep their values instead.
  */
-	void resize(int numRows, int numCols);
+	void resize(int numRows, int numCols, bool retainContents = false);
 
 /*
  * Method: getAt
@@ -152,6 +195,38 @@ public:
  */
 	GridRow operator[](int row);
 
+/*
+ * Method: rowSpan
+ * Usage: ElemType *rp = grid.rowSpan(row);
+ * ----------------------------------------
+ * This method returns a pointer to the first element of the given
+ * row, which is followed in memory by the rest of the row, so that
+ * rp[col] is the element at (row, col).  The row is checked once,
+ * but accesses through the pointer are not checked at all, which
+ * makes rowSpan suitable for inner loops that must run at full
+ * speed.  The pointer is valid until the grid is resized.  Raises
+ * an error if row is out of range or if the grid does not use the
+ * row-major layout.
+ */
+	ElemType *rowSpan(int row);
+
+/*
+ * Methods: fill, count, sum
+ * Usage: grid.fill(false);
+ *        n = grid.count(true);
+ *        total = grid.sum();
+ * ------------------------------
+ * These methods operate on every element of this grid at once.  The
+ * fill method sets each element to value, count returns the number
+ * of elements equal to value, and sum returns the total of all the
+ * elements, starting from the default value of the element type,
+ * which must support the += operator.  Each method runs in simple
+ * loops over contiguous memory that the compiler can vectorize.
+ */
+	void fill(ElemType value);
+	int count(ElemType value);
+	ElemType sum();
+
 /*
  * SPECIAL NOTE: mapping/iteration support
  * ---------------------------------------
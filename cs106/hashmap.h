@@ -0,0 +1,320 @@
+/*
+ * File: hashmap.h
+ * -----------------------------------------------------
+ * This interface file contains the HashMap class template, a
+ * collection for storing key-value pairs in which the key type,
+ * as well as the value type, is chosen by the client.
+ */
+
+#ifndef _hashmap_h
+#define _hashmap_h
+
+#include "genlib.h"
+#include "foreach.h"
+#include "instrument.h"
+#include <string>
+#include <cstring>
+
+/*
+ * Function: HashBytes
+ * Usage: hashCode = HashBytes(ptr, nBytes);
+ * -----------------------------------------
+ * This function computes a hash code for the nBytes bytes that begin
+ * at ptr.  It is used by the default HashCode functor, and is also
+ * available to clients writing hash functions for their own types.
+ */
+
+inline unsigned long HashBytes(const void *ptr, int nBytes) {
+	const unsigned char *cp = (const unsigned char *) ptr;
+	unsigned long hashCode = 2166136261UL;
+	for (int i = 0; i < nBytes; i++) {
+		hashCode = (hashCode ^ cp[i]) * 16777619UL;
+	}
+	return hashCode;
+}
+
+/*
+ * Class: HashCode
+ * ---------------
+ * This class template is the default hash function used by HashMap.
+ * The general version hashes the bytes of the key, which is correct
+ * for plain structures of integers (such as pointT) but not for types
+ * that contain pointers or padding.  Clients whose key types fall
+ * into that category must supply their own hash functor, which is
+ * any class with a const operator() that takes a key and returns an
+ * unsigned long.  Specializations are provided for strings and for
+ * the built-in integer types.
+ */
+
+template <typename KeyType>
+class HashCode {
+public:
+	unsigned long operator()(const KeyType & key) const {
+		return HashBytes(&key, sizeof(KeyType));
+	}
+};
+
+/*
+ * Implementation note: HashCode<string>
+ * -------------------------------------
+ * The string version also accepts a C string, which is hashed to
+ * the same value as the equivalent string object.  That makes it
+ * possible to look up a HashMap with string keys using a literal
+ * or a char buffer without constructing a temporary string.
+ */
+
+template <>
+class HashCode<string> {
+public:
+	unsigned long operator()(const string & key) const {
+		return HashBytes(key.data(), key.length());
+	}
+
+	unsigned long operator()(const char *key) const {
+		return HashBytes(key, strlen(key));
+	}
+};
+
+template <>
+class HashCode<int> {
+public:
+	unsigned long operator()(int key) const {
+		return (unsigned long) key;
+	}
+};
+
+template <>
+class HashCode<long> {
+public:
+	unsigned long operator()(long key) const {
+		return (unsigned long) key;
+	}
+};
+
+template <>
+class HashCode<unsigned long> {
+public:
+	unsigned long operator()(unsigned long key) const {
+		return key;
+	}
+};
+
+/*
+ * Class: HashMap
+ * --------------
+ * This interface defines a class template that stores a collection of
+ * key-value pairs.  It provides the same operations as the Map class,
+ * but the client chooses the key type as well as the value type, as
+ * in HashMap<string, int> or HashMap<pointT, int>.  The key type must
+ * support assignment and the == operator, and must be hashable by the
+ * hash functor, which defaults to HashCode<KeyType>.
+ *
+ * Methods that look up an existing key are templates over the type of
+ * their argument.  Any type that the hash functor accepts and that
+ * can be compared with == against a key may be used, which allows a
+ * HashMap<string, int> to be searched using a C string.
+ */
+
+template <typename KeyType, typename ValueType,
+          typename HashFn = HashCode<KeyType> >
+class HashMap {
+
+public:
+
+/* Forward references */
+	class Iterator;
+
+/*
+ * Constructor: HashMap
+ * Usage: HashMap<string, int> map;
+ *        HashMap<pointT, int> map(500);
+ *        HashMap<string, string> *mp = new HashMap<string, string>;
+ * ----------------------------------------------------------------
+ * The constructor initializes a new empty map.  The optional
+ * argument is a hint about the expected number of entries
+ * that this map will hold, which allows the map to allocate
+ * enough room for that many entries up front.  The explicit
+ * keyword is used to prevent accidental construction of a
+ * HashMap from an integer.  Raises an error if sizeHint is
+ * negative.
+ */
+	explicit HashMap(int sizeHint = 0);
+
+/*
+ * Destructor: ~HashMap
+ * Usage: delete mp;
+ * -----------------
+ * The destructor deallocates storage associated with this map.
+ */
+	~HashMap();
+
+/*
+ * Method: size
+ * Usage: nEntries = map.size();
+ * -----------------------------
+ * This method returns the number of entries in this map.
+ */
+	int size();
+
+/*
+ * Method: isEmpty
+ * Usage: if (map.isEmpty())...
+ * ----------------------------
+ * This method returns true if this map contains no
+ * entries, false otherwise.
+ */
+	bool isEmpty();
+
+/*
+ * Method: put
+ * Usage: map.put(key, value);
+ * ---------------------------
+ * This method associates key with value in this map.
+ * Any previous value associated with key is replaced by this new
+ * entry. If there was already an entry for this key, the map's
+ * size is unchanged; otherwise, it increments by one.
+ */
+	void put(const KeyType & key, const ValueType & value);
+
+/*
+ * Method: remove
+ * Usage: map.remove(key);
+ * -----------------------
+ * This method removes any entry for key from this map.
+ * If there is no entry for the key, the map is unchanged.
+ * Otherwise, the key and its associated value are removed and
+ * the map's size decreases by one.
+ */
+	template <typename KeyLike>
+	void remove(const KeyLike & key);
+
+/*
+ * Method: containsKey
+ * Usage: if (map.containsKey(key))...
+ * -----------------------------------
+ * Returns true if there is an entry for key in this map,
+ * false otherwise.
+ */
+	template <typename KeyLike>
+	bool containsKey(const KeyLike & key);
+
+/*
+ * Method: find
+ * Usage: ValueType *vp = map.find(key);
+ * -------------------------------------
+ * If key is found in this map, this method returns a pointer to
+ * the associated value, which may be used to update that value in
+ * place.  If key is not found, find returns NULL.  Unlike calling
+ * containsKey followed by get, this method searches the table only
+ * once.  The pointer remains valid until the map is next modified.
+ */
+	template <typename KeyLike>
+	ValueType *find(const KeyLike & key);
+
+/*
+ * Method: get
+ * Usage: value = map.get(key);
+ * ----------------------------
+ * If key is found in this map, this method returns the
+ * associated value.  If key is not found, raises an error. The
+ * containsKey method can be used to verify the presence
+ * of a key in the map before attempting to get its value.
+ */
+	template <typename KeyLike>
+	ValueType get(const KeyLike & key);
+
+/*
+ * Method: operator[]
+ * Usage: map[key] = newValue;
+ * ---------------------------
+ * This method overloads [] to access values from this map by key.
+ * If the key is already present in the map, this function returns
+ * a reference to its associated value, and the size of the map is
+ * unchanged. If key is not present in the map, a new entry for the
+ * key is added, and the size of the map increases by one. The
+ * value for the newly entered key is set to the default for value
+ * type, and a reference to that value is returned.
+ */
+	template <typename KeyLike>
+	ValueType & operator[](const KeyLike & key);
+
+/*
+ * Method: clear
+ * Usage: map.clear();
+ * -------------------
+ * This method removes all entries from this map. The
+ * map is made empty and will have size() = 0 after being cleared.
+ */
+	void clear();
+
+/*
+ * SPECIAL NOTE: mapping/iteration support
+ * ---------------------------------------
+ * The map supports both a mapping operation and an iterator which
+ * allow the client access to all entries one by one.  In general,
+ * these  are intended for _viewing_ entries and can behave
+ * unpredictably if you attempt to modify the map's contents during
+ * mapping/iteration.
+ */
+
+/*
+ * Method: mapAll
+ * Usage: map.mapAll(Print);
+ * -------------------------
+ * This method goes through every entry in this map
+ * and calls the function fn, passing it two arguments:
+ * the key and its associated value.
+ */
+	void mapAll(void (*fn)(KeyType key, ValueType val));
+
+/*
+ * Method: mapAll
+ * Usage: map.mapAll(PrintToFile, outputStream);
+ * ---------------------------------------------
+ * This method goes through every entry in this map
+ * and calls the function fn, passing it three arguments:
+ * the key, its associated value, and the client's data. That data
+ * can be of whatever type is needed for the client's callback.
+ */
+	template <typename ClientDataType>
+	void mapAll(void (*fn)(KeyType, ValueType, ClientDataType &),
+	            ClientDataType & data);
+
+/*
+ * Method: iterator
+ * Usage: iter = map.iterator();
+ * -----------------------------
+ * This method creates an iterator that allows the client to
+ * iterate through the keys in this map.  The map abstraction
+ * makes no guarantees about the order in which keys are returned.
+ *
+ * The idiomatic code for accessing elements using an iterator is
+ * to create the iterator from the collection and then enter a loop
+ * that calls next() while hasNext() is true, like this:
+ *
+ *     HashMap<string, int>::Iterator iter = map.iterator();
+ *     while (iter.hasNext()) {
+ *         string key = iter.next();
+ *         . . .
+ *     }
+ *
+ * This pattern can be abbreviated to the following more readable form:
+ *
+ *     foreach (string key in map) {
+ *         . . .
+ *     }
+ *
+ * To avoid exposing the details of the class, the definition of the
+ * Iterator class itself appears in the private/hashmap.h file.
+ */
+	Iterator iterator();
+
+private:
+
+#include "private/hashmap.h"
+
+};
+
+#include "private/hashmap.cpp"
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * File: instrument.h
+ * -----------------------------------------------------
+ * This interface exports an optional layer of counters that record
+ * how much work the collection classes do behind the scenes: how
+ * often they allocate memory and how much, how often they grow or
+ * rehash, how often they are copied, how many rotations the BST makes,
+ * and how many iterators foreach creates.
+ *
+ * The counters are compiled in only if CS106_INSTRUMENT is defined
+ * before the first collection header is included, typically on the
+ * compiler command line.  Otherwise the hooks inside the collections
+ * compile to nothing, and the functions below do nothing except report
+ * that instrumentation is off.
+ *
+ * Counts are kept separately for each collection class and for each
+ * site, which is a part of the program that the client labels with
+ * INSTRUMENT_SITE:
+ *
+ *      Vector<triangleT> solve(Vector<triangleT> & triangles) {
+ *          INSTRUMENT_SITE("solve");
+ *          . . .
+ *      }
+ *
+ * Every event from the point of the INSTRUMENT_SITE to the end of the
+ * enclosing block, including events in functions called from that
+ * block, is charged to the "solve" site.  Sites can be nested, in which
+ * case the innermost one is charged.  Events outside any site are
+ * charged to the site "(none)".  When instrumentation is on, a report
+ * is written to cerr when the program exits.
+ */
+
+#ifndef _instrument_h
+#define _instrument_h
+
+#include "genlib.h"
+#include <iostream>
+
+/*
+ * Type: instrumentEventT
+ * ----------------------
+ * This enumerated type lists the kinds of events that are counted.
+ */
+
+enum instrumentEventT {
+	AllocationEvent,
+	GrowEvent,
+	RehashEvent,
+	CopyEvent,
+	RotationEvent,
+	IteratorEvent
+};
+
+/*
+ * Macro: INSTRUMENT_EVENT
+ * Usage: INSTRUMENT_EVENT("Vector", AllocationEvent, nBytes);
+ * -----------------------------------------------------------
+ * This macro records one event of the given kind for the named
+ * collection class at the current site.  For allocation events, the
+ * last argument is the number of bytes allocated; for other events it
+ * is ignored.  The collection classes use this macro internally.
+ */
+
+#ifdef CS106_INSTRUMENT
+#define INSTRUMENT_EVENT(container, event, bytes) \
+	InstrumentCount(container, event, bytes)
+#else
+#define INSTRUMENT_EVENT(container, event, bytes) ((void) 0)
+#endif
+
+/*
+ * Macro: INSTRUMENT_SITE
+ * Usage: INSTRUMENT_SITE("solve");
+ * --------------------------------
+ * This macro charges the events in the rest of the enclosing block to
+ * the site with the given name, which must be a string literal or
+ * other string that lasts until the program exits.
+ */
+
+#ifdef CS106_INSTRUMENT
+#define INSTRUMENT_SITE(name) InstrumentSite _instrumentSite(name)
+#else
+#define INSTRUMENT_SITE(name) ((void) 0)
+#endif
+
+/*
+ * Function: InstrumentCount
+ * Usage: InstrumentCount("Vector", GrowEvent, 0);
+ * -----------------------------------------------
+ * This function records an event.  Clients should use the
+ * INSTRUMENT_EVENT macro instead, so that the call disappears when
+ * instrumentation is off.  It is safe to call from several threads.
+ */
+
+void InstrumentCount(const char *container, instrumentEventT event,
+                     long bytes);
+
+/*
+ * Function: InstrumentReport
+ * Usage: InstrumentReport();
+ *        InstrumentReport(outfile);
+ * ---------------------------------
+ * This function writes a table of the counts so far to the given
+ * stream, or to cerr if none is given, with one line for each
+ * combination of collection class and site that had any events.
+ */
+
+void InstrumentReport(ostream & out = cerr);
+
+/*
+ * Function: InstrumentReset
+ * Usage: InstrumentReset();
+ * -------------------------
+ * This function sets all the counts back to zero, which makes it
+ * possible to measure one phase of a program at a time.
+ */
+
+void InstrumentReset();
+
+/*
+ * Class: InstrumentSite
+ * ---------------------
+ * This class implements INSTRUMENT_SITE.  Constructing an object
+ * makes its name the current site for this thread, and destroying
+ * it restores the previous site.
+ */
+
+class InstrumentSite {
+public:
+	InstrumentSite(const char *name);
+	~InstrumentSite();
+
+private:
+	const char *previous;
+};
+
+#include "private/instrument.cpp"
+
+#endif
@@ -13,6 +13,8 @@
 #include "genlib.h"
 #include "vector.h"
 #include "foreach.h"
+#include "nodepool.h"
+#include "instrument.h"
 #include <string>
 #include <cstdlib>
 
@@ -51,6 +53,17 @@ public:
  */
 	explicit Map(int sizeHint = 101);
 
+/*
+ * Constructor: Map
+ * Usage: Map<int> map(101, pool);
+ * -------------------------------
+ * This constructor initializes a new empty map that allocates its
+ * entries from the specified NodePool instead of from a pool of its
+ * own.  Maps of the same type can share one pool, which must outlive
+ * all of them.  Raises an error if sizeHint is negative.
+ */
+	Map(int sizeHint, NodePool & pool);
+
 /*
  * Destructor: ~Map
  * Usage: delete mp;
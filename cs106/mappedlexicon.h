@@ -0,0 +1,132 @@
+/*
+ * File: mappedlexicon.h
+ * -----------------------------------------------------
+ * This interface exports the MappedLexicon class, a read-only
+ * lexicon that looks up words in a binary lexicon file without
+ * loading it.
+ */
+
+#ifndef _mappedlexicon_h
+#define _mappedlexicon_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "strutils.h"
+#include "private/mappedfile.h"
+#include <cctype>
+#include <cstring>
+
+/*
+ * Class: MappedLexicon
+ * --------------------
+ * This class answers the same word and prefix queries as Lexicon for
+ * a lexicon stored in the binary format that Lexicon reads (the
+ * ".dat" files).  Instead of reading the file into memory, it maps the
+ * file and walks the word graph in place, so opening a lexicon takes
+ * the same short time whatever its size, and several programs using
+ * the same file share a single copy in memory.
+ *
+ * A MappedLexicon cannot be changed once it is open.  Clients that
+ * need to add words or iterate over the lexicon should use Lexicon.
+ * Here is sample use of a MappedLexicon object:
+ *
+ *      MappedLexicon lex("lexicon.dat");
+ *      if (lex.containsPrefix("fru") || lex.containsWord("ball")) . . .
+ *
+ * For large numbers of lookups, the containsWords and containsPrefixes
+ * methods check a whole array of strings in one call, which is much
+ * faster than calling containsWord or containsPrefix in a loop.
+ */
+
+class MappedLexicon {
+
+public:
+
+/*
+ * Constructor: MappedLexicon
+ * Usage: MappedLexicon lex;
+ *        MappedLexicon lex("lexicon.dat");
+ * -----------------------------------------
+ * The constructor initializes a new lexicon.  If a filename is
+ * given, the constructor opens that file as described for the open
+ * method; otherwise the lexicon is empty until open is called.
+ */
+	MappedLexicon();
+	MappedLexicon(string filename);
+
+/*
+ * Destructor: ~MappedLexicon
+ * Usage: delete lp;
+ * -----------------
+ * The destructor releases the mapped lexicon file.
+ */
+	~MappedLexicon();
+
+/*
+ * Method: open
+ * Usage: lex.open("lexicon.dat");
+ * -------------------------------
+ * This method maps the named binary lexicon file, replacing any file
+ * that this lexicon was using before.  Only the short header of the
+ * file is read here; the rest is read by the operating system as the
+ * lookups reach it.  Raises an error if the file cannot be opened or
+ * does not have the form of a binary lexicon.
+ */
+	void open(string filename);
+
+/*
+ * Method: isEmpty
+ * Usage: if (lex.isEmpty()) . . .
+ * -------------------------------
+ * This method returns true if this lexicon contains no words.
+ */
+	bool isEmpty();
+
+/*
+ * Method: containsWord
+ * Usage: if (lex.containsWord("happy")) . . .
+ * -------------------------------------------
+ * This method returns true if word is contained in this lexicon,
+ * false otherwise.  As with Lexicon, words are considered
+ * case-insensitively.
+ */
+	bool containsWord(const string & word);
+
+/*
+ * Method: containsPrefix
+ * Usage: if (lex.containsPrefix("mo")) . . .
+ * ------------------------------------------
+ * This method returns true if any words in this lexicon begin with
+ * prefix, false otherwise.  As with Lexicon, a word is a prefix of
+ * itself, the empty string is a prefix of everything, and prefixes
+ * are considered case-insensitively.
+ */
+	bool containsPrefix(const string & prefix);
+
+/*
+ * Methods: containsWords, containsPrefixes
+ * Usage: lex.containsWords(words, n, results);
+ *        lex.containsPrefixes(prefixes, n, results);
+ * ------------------------------------------------
+ * These methods check each of the first n strings in the array and
+ * set the corresponding element of results to the value that
+ * containsWord or containsPrefix would return for it.  Each method
+ * returns the number of strings for which the result is true.
+ *
+ * The lookups are interleaved, so that while one is waiting for part
+ * of the file to arrive from memory, the others can make progress.
+ * On large lexicons this makes each lookup several times faster than
+ * it is through containsWord or containsPrefix.
+ */
+	int containsWords(const string words[], int n, bool results[]);
+	int containsPrefixes(const string prefixes[], int n, bool results[]);
+
+private:
+
+#include "private/mappedlexicon.h"
+
+};
+
+#include "private/mappedlexicon.cpp"
+
+#endif
@@ -0,0 +1,115 @@
+/*
+ * File: mpmcqueue.h
+ * -----------------------------------------------------
+ * This interface file contains the MPMCQueue class template, a
+ * bounded queue that any number of threads can share.
+ */
+
+#ifndef _mpmcqueue_h
+#define _mpmcqueue_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "private/backoff.h"
+#include <atomic>
+
+/*
+ * Class: MPMCQueue
+ * ----------------
+ * This interface defines a first-in-first-out queue that any number
+ * of producer threads and consumer threads can use at the same time.
+ * Like SPSCQueue, it holds at most a fixed number of elements, never
+ * allocates memory after it is created, and uses no locks, but each
+ * operation costs an atomic compare-and-swap so that threads on the
+ * same side can agree on which slot each one gets.
+ *
+ * The try methods return false immediately if the queue is full or
+ * empty, and the plain methods wait until the operation can be done.
+ * Elements from a single producer are dequeued in the order that
+ * producer enqueued them.  MPMCQueue objects cannot be copied.
+ */
+
+template <typename ElemType>
+class MPMCQueue {
+
+public:
+
+/*
+ * Constructor: MPMCQueue
+ * Usage: MPMCQueue<int> queue(1024);
+ * ----------------------------------
+ * The constructor initializes a new empty queue that can hold at least
+ * capacity elements.  The capacity is rounded up to a power of two,
+ * and to at least two.
+ */
+	explicit MPMCQueue(int capacity);
+
+/*
+ * Destructor: ~MPMCQueue
+ * Usage: delete qp;
+ * -----------------
+ * The destructor deallocates storage associated with this queue.
+ * No other thread may be using the queue when it is deleted.
+ */
+	~MPMCQueue();
+
+/*
+ * Method: capacity
+ * Usage: n = queue.capacity();
+ * ----------------------------
+ * This method returns the maximum number of elements the queue holds.
+ */
+	int capacity();
+
+/*
+ * Method: size
+ * Usage: nElems = queue.size();
+ * -----------------------------
+ * This method returns the number of elements in this queue.  While
+ * other threads are active, the result is only a snapshot.
+ */
+	int size();
+
+/*
+ * Method: isEmpty
+ * Usage: if (queue.isEmpty())...
+ * -------------------------------
+ * This method returns true if this queue contains no elements, with
+ * the same caveat as size.
+ */
+	bool isEmpty();
+
+/*
+ * Methods: tryEnqueue, enqueue
+ * Usage: if (queue.tryEnqueue(elem))...
+ *        queue.enqueue(elem);
+ * -------------------------------------
+ * These methods add elem to the end of this queue.  If the queue is
+ * full, tryEnqueue returns false without adding it, and enqueue waits
+ * until a consumer makes room.
+ */
+	bool tryEnqueue(const ElemType & elem);
+	void enqueue(const ElemType & elem);
+
+/*
+ * Methods: tryDequeue, dequeue
+ * Usage: if (queue.tryDequeue(elem))...
+ *        elem = queue.dequeue();
+ * -------------------------------------
+ * These methods remove the front element from this queue.  The
+ * tryDequeue method stores it in its argument and returns true, or
+ * returns false if the queue is empty.  The dequeue method returns
+ * the element, waiting for a producer if the queue is empty.
+ */
+	bool tryDequeue(ElemType & elem);
+	ElemType dequeue();
+
+private:
+
+#include "private/mpmcqueue.h"
+
+};
+
+#include "private/mpmcqueue.cpp"
+
+#endif
@@ -0,0 +1,106 @@
+/*
+ * File: nodepool.h
+ * -----------------------------------------------------
+ * This interface exports the NodePool class, an allocator for the
+ * fixed-size cells and nodes used inside the linked collection
+ * classes (Map and BST).
+ */
+
+#ifndef _nodepool_h
+#define _nodepool_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "instrument.h"
+#include <new>
+
+/*
+ * Class: NodePool
+ * ---------------
+ * A NodePool hands out blocks of memory that are all the same size,
+ * carving them out of large slabs that hold many blocks each.  Getting
+ * a block is usually just a matter of advancing a pointer, blocks that
+ * are allocated together sit next to each other in memory, and all of
+ * the slabs can be freed at once when the blocks are no longer needed.
+ *
+ * Each of the linked collections keeps a pool of its own by default.
+ * A client can instead create a NodePool and pass it to the
+ * constructors of several collections of the same type, which is
+ * useful when many small collections are created and destroyed
+ * together, for example one pool per thread:
+ *
+ *      NodePool pool;
+ *      Map<int> counts(101, pool), totals(101, pool);
+ *
+ * All the collections sharing a pool must use nodes of the same size,
+ * which is always true for collections of the same type.  A pool must
+ * outlive every collection that uses it.  NodePool is not itself
+ * thread-safe, so a shared pool must be used from a single thread.
+ */
+
+class NodePool {
+
+public:
+
+/*
+ * Constructor: NodePool
+ * Usage: NodePool pool;
+ *        NodePool pool(1024);
+ * ---------------------------
+ * The constructor initializes a new empty pool.  The first slab holds
+ * only a few blocks, and each slab after it holds twice as many as the
+ * one before, up to the number given by the optional argument.  A
+ * collection that stays small therefore uses little memory, while a
+ * large one still gets large slabs.  The size of the blocks is set by
+ * the first call to allocate.
+ */
+	explicit NodePool(int nodesPerSlab = 256);
+
+/*
+ * Destructor: ~NodePool
+ * Usage: delete pp;
+ * -----------------
+ * The destructor frees all of the slabs owned by this pool.
+ */
+	~NodePool();
+
+/*
+ * Method: allocate
+ * Usage: void *mem = pool.allocate(sizeof(cellT));
+ * ------------------------------------------------
+ * This method returns uninitialized storage for one node of the
+ * given size, which the caller constructs with placement new.
+ * Raises an error if nodeSize differs from the size used in
+ * earlier calls.
+ */
+	void *allocate(int nodeSize);
+
+/*
+ * Method: release
+ * Usage: pool.release(cp);
+ * ------------------------
+ * This method returns a single block, whose contents must already
+ * have been destroyed, to this pool for reuse by a later call to
+ * allocate.
+ */
+	void release(void *node);
+
+/*
+ * Method: clear
+ * Usage: pool.clear();
+ * --------------------
+ * This method frees every slab in this pool at once, invalidating
+ * all blocks handed out so far.  The contents of those blocks must
+ * already have been destroyed.
+ */
+	void clear();
+
+private:
+
+#include "private/nodepool.h"
+
+};
+
+#include "private/nodepool.cpp"
+
+#endif
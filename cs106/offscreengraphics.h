@@ -0,0 +1,193 @@
+/*
+ * File: offscreengraphics.h
+ * -----------------------------------------------------
+ * This interface exports the OffscreenGraphics class, which draws
+ * into an image in memory instead of into the graphics window.
+ */
+
+#ifndef _offscreengraphics_h
+#define _offscreengraphics_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "strutils.h"
+#include "vector.h"
+#include "map.h"
+#include <cmath>
+#include <cstring>
+
+/*
+ * Class: OffscreenGraphics
+ * ------------------------
+ * An OffscreenGraphics object is a canvas of a fixed size in pixels
+ * that supports the drawing operations of the graphics.h and
+ * extgraph.h interfaces, as methods with the same names written in
+ * lower camel case.  Because it does not need a window, it can be used
+ * in programs that run without a display, and the finished image can
+ * be written to a PNG or PPM file or examined pixel by pixel.
+ *
+ * The canvas uses screen coordinates, measured in pixels with the
+ * origin in the upper left corner, which is the coordinate system set
+ * up by InitPuzzleGraphics.  Here is a sample use:
+ *
+ *      OffscreenGraphics canvas(700, 400);
+ *      canvas.setPenColor("Blue");
+ *      canvas.startFilledRegion();
+ *      canvas.movePen(100, 300);
+ *      canvas.drawLine(200, 0);
+ *      canvas.drawLine(-100, -150);
+ *      canvas.drawLine(-100, 150);
+ *      canvas.endFilledRegion();
+ *      canvas.writePNG("triangle.png");
+ *
+ * Drawing text and pictures is not supported.
+ */
+
+class OffscreenGraphics {
+
+public:
+
+/*
+ * Constructor: OffscreenGraphics
+ * Usage: OffscreenGraphics canvas(width, height);
+ * -----------------------------------------------
+ * The constructor creates a canvas of the given size in pixels, with
+ * every pixel white, the pen at (0, 0), and the pen color black.
+ * Raises an error if either dimension is not positive.
+ */
+	OffscreenGraphics(int width, int height);
+
+/*
+ * Destructor: ~OffscreenGraphics
+ * Usage: delete cp;
+ * -----------------
+ * The destructor frees the memory used by the image.
+ */
+	~OffscreenGraphics();
+
+/*
+ * Methods: getWidth, getHeight
+ * Usage: width = canvas.getWidth();
+ * ---------------------------------
+ * These methods return the size of the canvas in pixels.
+ */
+	int getWidth();
+	int getHeight();
+
+/*
+ * Methods: movePen, drawLine, drawArc
+ * Usage: canvas.movePen(x, y);
+ *        canvas.drawLine(dx, dy);
+ *        canvas.drawArc(r, start, sweep);
+ * ---------------------------------------
+ * These methods move the pen and draw lines and arcs exactly as
+ * MovePen, DrawLine, and DrawArc do in graphics.h.  Arcs are drawn as
+ * a series of short lines.
+ */
+	void movePen(double x, double y);
+	void drawLine(double dx, double dy);
+	void drawArc(double r, double start, double sweep);
+
+/*
+ * Methods: getCurrentX, getCurrentY
+ * Usage: x = canvas.getCurrentX();
+ * --------------------------------
+ * These methods return the current position of the pen.
+ */
+	double getCurrentX();
+	double getCurrentY();
+
+/*
+ * Methods: startFilledRegion, endFilledRegion
+ * Usage: canvas.startFilledRegion(density);
+ *        . . . calls to drawLine and drawArc . . .
+ *        canvas.endFilledRegion();
+ * ------------------------------------------------
+ * These methods fill the shape outlined by the lines and arcs drawn
+ * between them, as StartFilledRegion and EndFilledRegion do in
+ * extgraph.h.  A density between 0 and 1 fills the shape with an even
+ * pattern of dots that covers that fraction of its pixels.  A pixel is
+ * filled if its center lies inside the shape.
+ */
+	void startFilledRegion(double density = 1.0);
+	void endFilledRegion();
+
+/*
+ * Method: fillBox
+ * Usage: canvas.fillBox(x, y, width, height);
+ * -------------------------------------------
+ * This method fills the rectangle with the given upper left corner
+ * and size in the pen color, as FillBox does in gpathfinder.h.
+ */
+	void fillBox(double x, double y, double width, double height);
+
+/*
+ * Methods: setPenColor, setPenColorRGB, defineColor, getPenColor
+ * Usage: canvas.setPenColor("Red");
+ *        canvas.setPenColorRGB(1.0, 0.5, 0.0);
+ *        canvas.defineColor("Brown", .35, .20, .05);
+ *        color = canvas.getPenColor();
+ * ---------------------------------------------------
+ * These methods set, define, and return pen colors as the functions
+ * with the same names do in extgraph.h.  The predefined colors are
+ * the same, and color names are compared without regard to case.
+ * Raises an error if setPenColor is given a name that is not defined.
+ */
+	void setPenColor(string color);
+	void setPenColorRGB(double red, double green, double blue);
+	void defineColor(string name, double red, double green, double blue);
+	string getPenColor();
+
+/*
+ * Methods: setEraseMode, getEraseMode
+ * Usage: canvas.setEraseMode(true);
+ * ---------------------------------
+ * While erase mode is on, drawing uses white in place of the pen
+ * color, as with SetEraseMode in extgraph.h.
+ */
+	void setEraseMode(bool mode);
+	bool getEraseMode();
+
+/*
+ * Method: getPixel
+ * Usage: int rgb = canvas.getPixel(x, y);
+ * ---------------------------------------
+ * This method returns the color of the pixel in column x and row y as
+ * an integer of the form 0xRRGGBB.  Raises an error if the pixel is
+ * outside the canvas.
+ */
+	int getPixel(int x, int y);
+
+/*
+ * Method: getPixels
+ * Usage: const unsigned char *pixels = canvas.getPixels();
+ * --------------------------------------------------------
+ * This method returns the image as an array of 4 * width * height
+ * bytes, holding the red, green, blue, and alpha values of each pixel
+ * in rows from top to bottom.  The alpha values are always 255.  The
+ * array belongs to the canvas and changes as the canvas is drawn on.
+ */
+	const unsigned char *getPixels();
+
+/*
+ * Methods: writePNG, writePPM
+ * Usage: canvas.writePNG("frame.png");
+ *        canvas.writePPM("frame.ppm");
+ * -------------------------------------
+ * These methods write the image to the named file in PNG format or
+ * in the binary PPM (P6) format.  The PNG file is not compressed,
+ * which makes it quick to write but about as large as the image in
+ * memory.  Raises an error if the file cannot be written.
+ */
+	void writePNG(string filename);
+	void writePPM(string filename);
+
+private:
+
+#include "private/offscreengraphics.h"
+
+};
+
+#include "private/offscreengraphics.cpp"
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * File: private/backoff.h
+ * -----------------------------------------------------
+ * This file exports the Backoff class, which the blocking methods of
+ * SPSCQueue and MPMCQueue use to wait for another thread.  It is kept
+ * in the private directory because clients have no need to see it.
+ */
+
+#ifndef _backoff_h
+#define _backoff_h
+
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define BACKOFF_USE_PAUSE 1
+#endif
+
+/*
+ * Class: Backoff
+ * --------------
+ * Each call to pause waits a little longer than the one before.  The
+ * first few calls spin on the processor for a doubling number of
+ * iterations, which is the cheapest way to wait when the other thread
+ * is only a few instructions away.  After that, each call yields the
+ * processor so that a waiting thread does not starve the thread it is
+ * waiting for.
+ */
+
+class Backoff {
+public:
+	Backoff() {
+		count = 0;
+	}
+
+	void pause() {
+		if (count < SPIN_LIMIT) {
+			for (int i = 0; i < (1 << count); i++) {
+				cpuRelax();
+			}
+			count++;
+		} else {
+			std::this_thread::yield();
+		}
+	}
+
+private:
+	static const int SPIN_LIMIT = 6;
+	int count;
+
+	static void cpuRelax() {
+#ifdef BACKOFF_USE_PAUSE
+		__builtin_ia32_pause();
+#endif
+	}
+};
+
+#endif
@@ -9,151 +9,219 @@
 
 #ifdef _bst_h
 
-template <typename ElemType>
-BST<ElemType>::BST(int (*cmp)(ElemType, ElemType)) {
+/*
+ * Implementation notes: BST class
+ * -------------------------------
+ * Each node keeps a pointer to its parent as well as to its children.
+ * The parent links let every operation run as a loop instead of a
+ * recursion: find and add walk down from the root, add and remove
+ * walk back up to fix the balance factors, teardown walks the tree in
+ * postorder, and the iterator moves from a node to its successor
+ * without keeping a stack of the nodes above it.
+ *
+ * The nodes of the tree come from a NodePool, either one owned by the
+ * tree or one supplied by the client.  When the tree owns its pool,
+ * deleting the whole tree destroys each node in place and then frees
+ * the slabs all at once instead of freeing the nodes one by one.
+ */
+
+template <typename ElemType, typename Comparator>
+BST<ElemType, Comparator>::BST(Comparator cmp) : cmpFn(cmp) {
+	root = NULL;
+	pool = &ownPool;
+	numNodes = 0;
+	timestamp = 0L;
+}
+
+template <typename ElemType, typename Comparator>
+BST<ElemType, Comparator>::BST(Comparator cmp, NodePool & sharedPool)
+                                                         : cmpFn(cmp) {
 	root = NULL;
-	cmpFn = cmp;
+	pool = &sharedPool;
 	numNodes = 0;
 	timestamp = 0L;
 }
 
-template <typename ElemType>
-BST<ElemType>::~BST() {
-	recDeleteTree(root);
+template <typename ElemType, typename Comparator>
+BST<ElemType, Comparator>::~BST() {
+	deleteAllNodes();
 }
 
-template <typename ElemType>
-void BST<ElemType>::recDeleteTree(nodeT * t) {
-	if (t != NULL) {
-		recDeleteTree(t->left);
-		recDeleteTree(t->right);
-		delete t;
+/*
+ * Implementation notes: deleteAllNodes
+ * ------------------------------------
+ * This method deletes the tree in postorder without recursion.  It
+ * descends to a leaf, deletes it, detaches it from its parent, and
+ * continues from the parent, which may by then have become a leaf.
+ */
+
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::deleteAllNodes() {
+	bool ownsPool = (pool == &ownPool);
+	nodeT *t = root;
+	while (t != NULL) {
+		if (t->left != NULL) {
+			t = t->left;
+		} else if (t->right != NULL) {
+			t = t->right;
+		} else {
+			nodeT *parent = t->parent;
+			if (parent != NULL) {
+				if (parent->left == t) {
+					parent->left = NULL;
+				} else {
+					parent->right = NULL;
+				}
+			}
+			if (ownsPool) {
+				t->~nodeT();
+			} else {
+				deleteNode(t);
+			}
+			t = parent;
+		}
 	}
+	root = NULL;
+	if (ownsPool) ownPool.clear();
+}
+
+template <typename ElemType, typename Comparator>
+typename BST<ElemType, Comparator>::nodeT *
+         BST<ElemType, Comparator>::newNode() {
+	return new (pool->allocate(sizeof(nodeT))) nodeT;
+}
+
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::deleteNode(nodeT *t) {
+	t->~nodeT();
+	pool->release(t);
 }
 
-template <typename ElemType>
-int BST<ElemType>::size() {
+template <typename ElemType, typename Comparator>
+int BST<ElemType, Comparator>::size() {
 	return numNodes;
 }
 
-template <typename ElemType>
-bool BST<ElemType>::isEmpty() {
+template <typename ElemType, typename Comparator>
+bool BST<ElemType, Comparator>::isEmpty() {
 	return root == NULL;
 }
 
-template <typename ElemType>
-void BST<ElemType>::clear() {
-	recDeleteTree(root);
-	root = NULL;
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::clear() {
+	deleteAllNodes();
 	numNodes = 0;
 	timestamp++;
 }
 
 /*
- * Implementation notes: find, recFindNode
- * ---------------------------------------
- * The find method simply calls recFindNode to do the work.
- * The recursive function takes the current node along with the
- * original argument.  If found, it overwrites the reference
- * parameter with the copy and returns a pointer to the data.
+ * Implementation notes: find, findNode
+ * ------------------------------------
+ * The find method calls findNode, which walks down from the root
+ * comparing the key against each node until it finds a match or
+ * runs off the bottom of the tree.
  */
 
-template <typename ElemType>
-ElemType *BST<ElemType>::find(ElemType key) {
-	nodeT *found = recFindNode(root, key);
+template <typename ElemType, typename Comparator>
+ElemType *BST<ElemType, Comparator>::find(const ElemType & key) {
+	nodeT *found = findNode(key);
 	if (found == NULL) return NULL;
 	return &found->data;
 }
 
-template <typename ElemType>
-typename BST<ElemType>::nodeT *BST<ElemType>::recFindNode(nodeT *t,
-	                                                  ElemType & key) {
-	if (t == NULL) return NULL;
-	int sign = cmpFn(key, t->data);
-	if (sign == 0) return t;
-	if (sign < 0) {
-		return recFindNode(t->left, key);
-	} else {
-		return recFindNode(t->right, key);
+template <typename ElemType, typename Comparator>
+typename BST<ElemType, Comparator>::nodeT *
+         BST<ElemType, Comparator>::findNode(const ElemType & key) {
+	nodeT *t = root;
+	while (t != NULL) {
+		int sign = cmpFn(key, t->data);
+		if (sign == 0) return t;
+		t = (sign < 0) ? t->left : t->right;
 	}
+	return NULL;
 }
 
 /*
- * Implementation notes: add, recAddNode
- * -------------------------------------
- * The add method is implemented as a simple wrapper
- * to recAddNode, which does all the work.  The difference
- * between the prototypes is that recAddNode takes a reference
- * to the root of the current subtree as an extra argument.
- * For reasons of efficiency (we don't know how large ElemType
- * might be), we pass it by reference.
- *
- * The return value from recAddNode is true or false, depending on
- * whether the height of the subtree was increased by one or not.
- * At base case, returns true for new node, false for overwite. As
- * it works its way upwards, if that additional height is added to
- * to existing balanace factor and results in factor that is
- * more than +- 1, then a rotation is done to fix the imbalance.
+ * Implementation notes: add
+ * -------------------------
+ * The add method first walks down the tree to find either a node
+ * with the same value, which it overwrites, or the empty link where
+ * the new node belongs.  After linking in the new node, it retraces
+ * the path back toward the root, adjusting the balance factor of each
+ * ancestor.  The retracing stops at the first ancestor whose subtree
+ * did not get taller: one that is now in balance, or one that needed
+ * a rotation, since a rotation after an insertion restores the
+ * subtree to its previous height.
  */
 
-template <typename ElemType>
-bool BST<ElemType>::add(ElemType data) {
-	bool createdNewNode = false;
-	recAddNode(root, data, createdNewNode);
-	if (createdNewNode) timestamp++;
-	return createdNewNode;
-}
-
-template <typename ElemType>
-bool BST<ElemType>::recAddNode(nodeT * & t, ElemType & data,
-                               bool & createdNewNode) {
-	if (t == NULL) {
-		t = new nodeT;
-		t->data = data;
-		t->bf = BST_IN_BALANCE;
-		t->left = t->right = NULL;
-		createdNewNode = true;
-		numNodes++;
-		return true;
-	}
-	int sign = cmpFn(data, t->data);
-	if (sign == 0) {
-		t->data = data;
-		createdNewNode = false;
-		return false;
-	}
-	int bfDelta = 0;
-	if (sign < 0) {
-		if (recAddNode(t->left, data, createdNewNode)) {
-			bfDelta = -1;   /* left subtree is higher */
+template <typename ElemType, typename Comparator>
+bool BST<ElemType, Comparator>::add(const ElemType & data) {
+	nodeT *parent = NULL;
+	nodeT **link = &root;
+	while (*link != NULL) {
+		parent = *link;
+		int sign = cmpFn(data, parent->data);
+		if (sign == 0) {
+			parent->data = data;
+			return false;
 		}
-	} else {
-		if (recAddNode(t->right, data, createdNewNode)) {
-			bfDelta = +1;   /* right subtree is higher */
+		link = (sign < 0) ? &parent->left : &parent->right;
+	}
+	nodeT *t = newNode();
+	t->data = data;
+	t->bf = BST_IN_BALANCE;
+	t->left = t->right = NULL;
+	t->parent = parent;
+	*link = t;
+	numNodes++;
+	timestamp++;
+	while (parent != NULL) {
+		parent->bf += (parent->left == t) ? -1 : +1;
+		if (parent->bf == BST_IN_BALANCE) break;
+		if (parent->bf < BST_LEFT_HEAVY || parent->bf > BST_RIGHT_HEAVY) {
+			rebalance(parent);
+			break;
 		}
+		t = parent;
+		parent = t->parent;
 	}
-	updateBF(t, bfDelta);
-	return (bfDelta != 0 && t->bf != BST_IN_BALANCE);
+	return true;
 }
 
 /*
- * Function: updateBF
- * Usage: updateBF(t, bfDelta);
- * ----------------------------
- * Updates the balance factor in the node and rebalances the
- * tree if necessary.
+ * Function: rebalance
+ * Usage: rebalance(t);
+ * --------------------
+ * Rebalances the subtree rooted at t, whose balance factor has
+ * reached +2 or -2, by calling fixLeftImbalance or fixRightImbalance
+ * on the link that points to t.
  */
 
-template <typename ElemType>
-void BST<ElemType>::updateBF(nodeT * & t, int bfDelta) {
-	t->bf += bfDelta;
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::rebalance(nodeT *t) {
+	nodeT * & link = linkTo(t);
 	if (t->bf < BST_LEFT_HEAVY) {
-		fixLeftImbalance(t);
-	} else if (t->bf > BST_RIGHT_HEAVY) {
-		fixRightImbalance(t);
+		fixLeftImbalance(link);
+	} else {
+		fixRightImbalance(link);
 	}
 }
 
+/*
+ * Function: linkTo
+ * Usage: nodeT * & link = linkTo(t);
+ * ----------------------------------
+ * Returns a reference to the pointer that points to t, which is
+ * either the root or a child pointer in the parent of t.
+ */
+
+template <typename ElemType, typename Comparator>
+typename BST<ElemType, Comparator>::nodeT * &
+         BST<ElemType, Comparator>::linkTo(nodeT *t) {
+	if (t->parent == NULL) return root;
+	return (t->parent->left == t) ? t->parent->left : t->parent->right;
+}
+
 /*
  * Function: fixLeftImbalance
  * Usage: fixLeftImbalance(t);
@@ -164,8 +232,8 @@ void BST<ElemType>::updateBF(nodeT * & t, int bfDelta) {
  * code performs a single or double rotation.
  */
 
-template <typename ElemType>
-void BST<ElemType>::fixLeftImbalance(nodeT * & t) {
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::fixLeftImbalance(nodeT * & t) {
 	nodeT *child = t->left;
 	if (child->bf == BST_RIGHT_HEAVY) {
 		int oldBF = child->right->bf;
@@ -200,16 +268,20 @@ void BST<ElemType>::fixLeftImbalance(nodeT * & t) {
  * Usage: rotateLeft(t);
  * ---------------------
  * This function performs a single left rotation of the tree
- * that is passed by reference.  The balance factors
- * are unchanged by this function and must be corrected at a
- * higher level of the algorithm.
+ * that is passed by reference, updating the parent links of the
+ * nodes that move.  The balance factors are unchanged by this
+ * function and must be corrected at a higher level of the algorithm.
  */
 
-template <typename ElemType>
-void BST<ElemType>::rotateLeft(nodeT * & t) {
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::rotateLeft(nodeT * & t) {
+	INSTRUMENT_EVENT("BST", RotationEvent, 0);
 	nodeT * child = t->right;
 	t->right = child->left;
+	if (child->left != NULL) child->left->parent = t;
 	child->left = t;
+	child->parent = t->parent;
+	t->parent = child;
 	t = child;
 }
 
@@ -223,8 +295,8 @@ void BST<ElemType>::rotateLeft(nodeT * & t) {
  * code performs a single or double rotation.
  */
 
-template <typename ElemType>
-void BST<ElemType>::fixRightImbalance(nodeT * & t) {
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::fixRightImbalance(nodeT * & t) {
 	nodeT *child = t->right;
 	if (child->bf == BST_LEFT_HEAVY) {
 		int oldBF = child->left->bf;
@@ -259,16 +331,20 @@ void BST<ElemType>::fixRightImbalance(nodeT * & t) {
  * Usage: rotateRight(t);
  * ----------------------
  * This function performs a single right rotation of the tree
- * that is passed by reference.  The balance factors
- * are unchanged by this function and must be corrected at a
- * higher level of the algorithm.
+ * that is passed by reference, updating the parent links of the
+ * nodes that move.  The balance factors are unchanged by this
+ * function and must be corrected at a higher level of the algorithm.
  */
 
-template <typename ElemType>
-void BST<ElemType>::rotateRight(nodeT * & t) {
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::rotateRight(nodeT * & t) {
+	INSTRUMENT_EVENT("BST", RotationEvent, 0);
 	nodeT * child = t->left;
 	t->left = child->right;
+	if (child->right != NULL) child->right->parent = t;
 	child->right = t;
+	child->parent = t->parent;
+	t->parent = child;
 	t = child;
 }
 
@@ -276,129 +352,129 @@ void BST<ElemType>::rotateRight(nodeT * & t) {
  * Implementation notes: remove
  * ----------------------------
  * The first step in removing a node is to find it using binary
- * search, which is performed by the recRemoveNode method.  If the
- * node is found, RemoveTargetNode does the actual deletion.
- */
-
-template <typename ElemType>
-bool BST<ElemType>::remove(ElemType data) {
-	bool didRemove = false;
-	recRemoveNode(root, data, didRemove);
-	if (didRemove) timestamp++;
-	return didRemove;
-}
-
-/*
- * Implementation notes: recRemoveNode
- * -----------------------------------
- * This method implements the general case for removing a node.
- * In addition to taking the root of the tree as a parameter, this
- * method takes a flag called didRemove, which is set if a matching
- * was found in the search.  The function returns the change in the
- * size of the tree rooted at t.
+ * search.  The easy case occurs when either of the children is NULL;
+ * all you need to do is replace the node with its non-NULL child.
+ * If both children are non-NULL, this code finds the rightmost
+ * descendent of the left child, which has no right child, moves its
+ * data into the target node, and removes that node instead.  Either
+ * way, the removeNode method does the unlinking and rebalancing.
  */
 
-template <typename ElemType>
-bool BST<ElemType>::recRemoveNode(nodeT * & t, ElemType & data,
-                                  bool & didRemove) {
+template <typename ElemType, typename Comparator>
+bool BST<ElemType, Comparator>::remove(const ElemType & data) {
+	nodeT *t = findNode(data);
 	if (t == NULL) return false;
-	int sign = cmpFn(data, t->data);
-	if (sign == 0) {
-		didRemove = true;
-		return removeTargetNode(t);
-	}
-	int bfDelta = 0;
-	if (sign < 0) {
-		if (recRemoveNode(t->left, data, didRemove)) bfDelta = +1;
-	} else {
-		if (recRemoveNode(t->right, data, didRemove)) bfDelta = -1;
+	if (t->left != NULL && t->right != NULL) {
+		nodeT *predecessor = t->left;
+		while (predecessor->right != NULL) {
+			predecessor = predecessor->right;
+		}
+		t->data = predecessor->data;
+		t = predecessor;
 	}
-	updateBF(t, bfDelta);
-	return (bfDelta != 0 && t->bf == BST_IN_BALANCE);
+	removeNode(t);
+	timestamp++;
+	return true;
 }
 
 /*
- * Implementation notes: removeTargetNode
- * --------------------------------------
- * This function removes the node which is passed by
- * reference as t.  The easy case occurs when either of the
- * children is NULL; all you need to do is replace the node with
- * its non-NULL child.  If both children are non-NULL, this code
- * finds the rightmost descendent of the left child; this node
- * may not be a leaf, but will have no right child.  Its left
- * child replaces it in the tree, after which the replacement
- * data is moved to the position occupied by the target node.
+ * Implementation notes: removeNode
+ * --------------------------------
+ * This method removes a node that has at most one child by linking
+ * that child to the node's parent.  It then retraces the path toward
+ * the root.  Each ancestor whose subtree got shorter has its balance
+ * factor adjusted, and the retracing stops at the first ancestor
+ * whose height did not change: one that was in balance before, or
+ * one whose rotation left the height the same, which happens when the
+ * taller child was itself in balance.
  */
 
-template <typename ElemType>
-bool BST<ElemType>::removeTargetNode(nodeT *  & t) {
-	nodeT *toDelete = t;
-	if (t->left == NULL) {          /* No left child, replace with right */
-		t = t->right;
-		delete toDelete;
-		numNodes--;
-		return true;
-	} else if (t->right == NULL) {  /* No right child, replace with left */
-		t = t->left;
-		delete toDelete;
-		numNodes--;
-		return true;
-	} else {  /* node has both children, replace with max of left */
-		nodeT *successor = t->left;
-		while (successor->right != NULL) {
-			successor = successor->right;
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::removeNode(nodeT *t) {
+	nodeT *child = (t->left != NULL) ? t->left : t->right;
+	nodeT *parent = t->parent;
+	bool fromLeft = (parent != NULL && parent->left == t);
+	linkTo(t) = child;
+	if (child != NULL) child->parent = parent;
+	deleteNode(t);
+	numNodes--;
+	while (parent != NULL) {
+		parent->bf += fromLeft ? +1 : -1;
+		if (parent->bf == BST_LEFT_HEAVY || parent->bf == BST_RIGHT_HEAVY) {
+			break;
 		}
-		t->data = successor->data;
-		bool unused;
-		if (recRemoveNode(t->left, successor->data, unused)) {
-			updateBF(t, 1);
-			return (t->bf == BST_IN_BALANCE);
+		nodeT *next = parent->parent;
+		bool nextFromLeft = (next != NULL && next->left == parent);
+		if (parent->bf != BST_IN_BALANCE) {
+			nodeT *taller = (parent->bf > 0) ? parent->right : parent->left;
+			bool heightUnchanged = (taller->bf == BST_IN_BALANCE);
+			rebalance(parent);
+			if (heightUnchanged) break;
 		}
-		return false;
+		parent = next;
+		fromLeft = nextFromLeft;
 	}
 }
 
 /*
- * Implementation notes: mapAll, recBSTAll
- * ----------------------------------------
- * The mapAll function is implemented as a wrapper to the
- * recursive function recBSTAll, which does the actual work
- * of calling the function on all values during an InOrder walk.
+ * Implementation notes: mapAll
+ * ----------------------------
+ * The mapAll functions walk the tree in order by starting at the
+ * leftmost node and repeatedly stepping to the successor.
  */
-template <typename ElemType>
-void BST<ElemType>::mapAll(void (*fn)(ElemType)) {
-	recBSTAll(root, fn);
-}
 
-template <typename ElemType>
-void BST<ElemType>::recBSTAll(nodeT * t, void (*fn)(ElemType)) {
-	if (t != NULL) {
-		recBSTAll(t->left, fn);
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::mapAll(void (*fn)(ElemType)) {
+	for (nodeT *t = leftmost(root); t != NULL; t = successor(t)) {
 		fn(t->data);
-		recBSTAll(t->right, fn);
 	}
 }
 
-template <typename ElemType>
+template <typename ElemType, typename Comparator>
 template <typename ClientDataType>
-	void BST<ElemType>::mapAll(void (*fn)(ElemType, ClientDataType &),
-	                           ClientDataType & data) {
-		recBSTAll(root, fn, data);
+void BST<ElemType, Comparator>::mapAll(void (*fn)(ElemType, ClientDataType &),
+                                       ClientDataType & data) {
+	for (nodeT *t = leftmost(root); t != NULL; t = successor(t)) {
+		fn(t->data, data);
 	}
+}
 
-template <typename ElemType>
-template <typename ClientDataType>
-void BST<ElemType>::recBSTAll(nodeT *t, void (*fn)(ElemType, ClientDataType &),
-                              ClientDataType & data) {
-	if (t != NULL) {
-		recBSTAll(t->left, fn ,data);
-		fn(t->data, data);
-		recBSTAll(t->right, fn, data);
+/*
+ * Functions: leftmost, successor
+ * Usage: t = leftmost(t);
+ *        t = successor(t);
+ * ------------------------
+ * The leftmost function returns the node with the smallest value in
+ * the subtree rooted at t, or NULL if t is NULL.  The successor
+ * function returns the node that follows t in an inorder walk, or
+ * NULL if t is the last node.  If t has a right subtree, the
+ * successor is the leftmost node in that subtree; otherwise, it is
+ * the first ancestor reached from a left child.
+ */
+
+template <typename ElemType, typename Comparator>
+typename BST<ElemType, Comparator>::nodeT *
+         BST<ElemType, Comparator>::leftmost(nodeT *t) {
+	if (t == NULL) return NULL;
+	while (t->left != NULL) {
+		t = t->left;
 	}
+	return t;
 }
 
-template <typename ElemType>
-const BST<ElemType> &BST<ElemType>::operator=(const BST & rhs) {
+template <typename ElemType, typename Comparator>
+typename BST<ElemType, Comparator>::nodeT *
+         BST<ElemType, Comparator>::successor(nodeT *t) {
+	if (t->right != NULL) return leftmost(t->right);
+	while (t->parent != NULL && t->parent->right == t) {
+		t = t->parent;
+	}
+	return t->parent;
+}
+
+template <typename ElemType, typename Comparator>
+const BST<ElemType, Comparator> &
+      BST<ElemType, Comparator>::operator=(const BST & rhs) {
 	if (this != &rhs) {
 		clear();
 		copyOtherEntries(rhs);
@@ -407,15 +483,16 @@ const BST<ElemType> &BST<ElemType>::operator=(const BST & rhs) {
 	return *this;
 }
 
-template <typename ElemType>
-BST<ElemType>::BST(const BST & rhs) {
+template <typename ElemType, typename Comparator>
+BST<ElemType, Comparator>::BST(const BST & rhs) : cmpFn(rhs.cmpFn) {
 	root = NULL;
+	pool = &ownPool;
 	copyOtherEntries(rhs);
 	timestamp = 0L;
 }
 
-template <typename ElemType>
-static void AddToTree(ElemType elem, BST<ElemType> & tree) {
+template <typename ElemType, typename Comparator>
+static void AddToTree(ElemType elem, BST<ElemType, Comparator> & tree) {
 	tree.add(elem);
 }
 
@@ -436,92 +513,68 @@ static void AddToTree(ElemType elem, BST<ElemType> & tree) {
  * dual-templated map function correctly.
  */
 
-template <typename ElemType>
-void BST<ElemType>::copyOtherEntries(const BST & constRhs) {
+template <typename ElemType, typename Comparator>
+void BST<ElemType, Comparator>::copyOtherEntries(const BST & constRhs) {
+	INSTRUMENT_EVENT("BST", CopyEvent, 0);
 	BST & rhs = const_cast<BST &>(constRhs);
 	cmpFn = rhs.cmpFn;
-	rhs.mapAll< BST<ElemType> >(AddToTree, *this);
+	rhs.mapAll< BST<ElemType, Comparator> >(AddToTree, *this);
 	numNodes = rhs.numNodes;
 }
 
 /*
  * BST::Iterator class implementation
+ * ----------------------------------
+ * The iterator holds a pointer to the next node to return and uses
+ * the parent links to step to its successor, so iterating over the
+ * tree allocates no memory.
  */
 
-template <typename ElemType>
-BST<ElemType>::Iterator::Iterator() {
+template <typename ElemType, typename Comparator>
+BST<ElemType, Comparator>::Iterator::Iterator() {
 	bstp = NULL;
 }
 
-template <typename ElemType>
-typename BST<ElemType>::Iterator BST<ElemType>::iterator() {
+template <typename ElemType, typename Comparator>
+typename BST<ElemType, Comparator>::Iterator
+         BST<ElemType, Comparator>::iterator() {
 	return Iterator(this);
 }
 
-template <typename ElemType>
-BST<ElemType>::Iterator::Iterator(BST *bstptr) {
+template <typename ElemType, typename Comparator>
+BST<ElemType, Comparator>::Iterator::Iterator(BST *bstptr) {
 	bstp = bstptr;
 	timestamp = bstp->timestamp;
-	if (bstp->root == NULL) return;
-	iteratorMarkerT marker = { (void *) bstp->root, false };
-	stack.push(marker);
-	findLeftmostChild();
+	np = (void *) leftmost(bstp->root);
 }
 
-template <typename ElemType>
-bool BST<ElemType>::Iterator::hasNext() {
+template <typename ElemType, typename Comparator>
+bool BST<ElemType, Comparator>::Iterator::hasNext() {
 	if (bstp == NULL) Error("hasNext called on uninitialized iterator");
 	if (timestamp != bstp->timestamp) {
 		Error("BST structure has been modified");
 	}
-	return !stack.isEmpty();
+	return np != NULL;
 }
 
-template <typename ElemType>
-ElemType BST<ElemType>::Iterator::next() {
+template <typename ElemType, typename Comparator>
+ElemType BST<ElemType, Comparator>::Iterator::next() {
 	if (bstp == NULL) Error("next called on uninitialized iterator");
 	if (!hasNext()) {
 		Error("Attempt to get next from iterator"
 		      " where hasNext() is false");
 	}
-	nodeT *np = (nodeT *) stack.peek().np;
-	ElemType result = np->data;
-	advanceToNextNode();
-	return result;
-}
-
-template <typename ElemType>
-void BST<ElemType>::Iterator::advanceToNextNode() {
-	iteratorMarkerT marker = stack.pop();
-	nodeT *np = (nodeT *) marker.np;
-	if (np->right == NULL) {
-		while (!stack.isEmpty() && stack.peek().processed) {
-			stack.pop();
-		}
-	} else {
-		marker.processed = true;
-		stack.push(marker);
-		marker.np = (void *) np->right;
-		marker.processed = false;
-		stack.push(marker);
-		findLeftmostChild();
-	}
+	nodeT *t = (nodeT *) np;
+	np = (void *) successor(t);
+	return t->data;
 }
 
-template <typename ElemType>
-void BST<ElemType>::Iterator::findLeftmostChild() {
-	nodeT *np = (nodeT *) stack.peek().np;
-	if (np == NULL) return;
-	while (np->left != NULL) {
-		iteratorMarkerT marker = { (void *) np->left,  false };
-		stack.push(marker);
-		np = np->left;
+template <typename ElemType, typename Comparator>
+ElemType BST<ElemType, Comparator>::foreachHook(FE_State & fe) {
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("BST", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
 	}
-}
-
-template <typename ElemType>
-ElemType BST<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
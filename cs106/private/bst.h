@@ -11,30 +11,23 @@
 public:
 
 /*
- * Class: BST<ElemType>::Iterator
- * ------------------------------
+ * Class: BST<ElemType, Comparator>::Iterator
+ * ------------------------------------------
  * This interface defines a nested class within the BST template that
  * provides iterator access to the keys contained in the BST.
  */
 
-	class Iterator {
+	class Iterator : public FE_Iterator {
 	public:
 		Iterator();
 		bool hasNext();
 		ElemType next();
 
 	private:
-		struct iteratorMarkerT {
-			void *np;
-			bool processed;
-		};
-
 		Iterator(BST *bstp);
 		BST *bstp;
-		Stack<iteratorMarkerT> stack;
+		void *np;          /* Next node to return, NULL at the end */
 		long timestamp;
-		void advanceToNextNode();
-		void findLeftmostChild();
 		friend class BST;
 	};
 	friend class Iterator;
@@ -62,6 +55,7 @@ private:
 	struct nodeT {
 		ElemType data;
 		nodeT *left, *right;
+		nodeT *parent;
 		int bf;    /* AVL balance factor */
 	};
 
@@ -74,24 +68,22 @@ private:
 	nodeT *root;
 	int numNodes;
 	long timestamp;
-	int (*cmpFn)(ElemType, ElemType);
+	Comparator cmpFn;
+	NodePool ownPool;
+	NodePool *pool;
 
 /* Private method prototypes */
-	nodeT *recFindNode(nodeT *t, ElemType & key);
-	bool recAddNode(nodeT * & t, ElemType & key, bool & createdNewNode);
-	bool recRemoveNode(nodeT * & t, ElemType & key, bool & didRemove);
-	bool removeTargetNode(nodeT * & t);
-	void updateBF(nodeT * & t, int bfDelta);
-	void recDeleteTree(nodeT *t);
-	void recBSTAll(nodeT *t, void (*fn)(ElemType));
+	nodeT *findNode(const ElemType & key);
+	void removeNode(nodeT *t);
+	nodeT * & linkTo(nodeT *t);
+	void rebalance(nodeT *t);
+	void deleteAllNodes();
+	nodeT *newNode();
+	void deleteNode(nodeT *t);
+	static nodeT *leftmost(nodeT *t);
+	static nodeT *successor(nodeT *t);
 	void fixRightImbalance(nodeT * & t);
 	void fixLeftImbalance(nodeT * & t);
 	void rotateRight(nodeT * & t);
 	void rotateLeft(nodeT * & t);
 	void copyOtherEntries(const BST & other);
-
-/* Template method prototypes */
-
-	template <typename ClientDataType>
-	void recBSTAll(nodeT *t, void (*fn)(ElemType, ClientDataType &),
-	               ClientDataType & data);
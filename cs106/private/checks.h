@@ -0,0 +1,48 @@
+/*
+ * File: private/checks.h
+ * -----------------------------------------------------
+ * This file defines the macros that decide whether the collection
+ * classes check their arguments on every element access.  It is kept
+ * in the private directory because clients control it only through
+ * the macros described below, which must be defined before the first
+ * collection header is included, typically on the compiler command
+ * line.
+ *
+ * By default the checks follow the standard NDEBUG convention: they
+ * are on in debug builds and off in builds that define NDEBUG.  A
+ * program can override that for every collection at once by defining
+ * CS106_CHECKS to 1 or 0, or for a single collection class by defining
+ * VECTOR_CHECKS or GRID_CHECKS, which take precedence over
+ * CS106_CHECKS.
+ *
+ * With checks off, Vector element access compiles to plain array
+ * indexing, Grid element access to the index arithmetic of its layout,
+ * and iterators and mapAll no longer detect changes to the collection
+ * while they are running.  An index out of range then has undefined
+ * behavior instead of raising an error, so checks should only be
+ * turned off in code that has already been tested with them on.
+ * Operations that change the structure of a collection, such as
+ * insertAt and removeAt, are always checked.  The program in
+ * benchmarks/checksbench.cpp measures what the checks cost.
+ */
+
+#ifndef _checks_h
+#define _checks_h
+
+#ifndef CS106_CHECKS
+#ifdef NDEBUG
+#define CS106_CHECKS 0
+#else
+#define CS106_CHECKS 1
+#endif
+#endif
+
+#ifndef VECTOR_CHECKS
+#define VECTOR_CHECKS CS106_CHECKS
+#endif
+
+#ifndef GRID_CHECKS
+#define GRID_CHECKS CS106_CHECKS
+#endif
+
+#endif
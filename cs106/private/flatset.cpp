@@ -0,0 +1,468 @@
+/*
+ * File: private/flatset.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the flatset.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _flatset_h
+
+/*
+ * Implementation notes: FlatSet class
+ * -----------------------------------
+ * The elements are kept in a dynamic array in increasing order, with
+ * no duplicates.  As in Vector, the array is enlarged by doubling, and
+ * the timestamp records structural changes so that iterators can
+ * detect them.
+ */
+
+template <typename ElemType, typename Comparator>
+FlatSet<ElemType, Comparator>::FlatSet(Comparator cmp) : cmpFn(cmp) {
+	elements = NULL;
+	numAllocated = numUsed = 0;
+	timestamp = 0L;
+}
+
+template <typename ElemType, typename Comparator>
+FlatSet<ElemType, Comparator>::FlatSet(const ElemType array[], int n,
+                                       Comparator cmp) : cmpFn(cmp) {
+	elements = NULL;
+	numAllocated = numUsed = 0;
+	timestamp = 0L;
+	addAll(array, n);
+}
+
+template <typename ElemType, typename Comparator>
+FlatSet<ElemType, Comparator>::~FlatSet() {
+	delete[] elements;
+}
+
+template <typename ElemType, typename Comparator>
+int FlatSet<ElemType, Comparator>::size() {
+	return numUsed;
+}
+
+template <typename ElemType, typename Comparator>
+bool FlatSet<ElemType, Comparator>::isEmpty() {
+	return numUsed == 0;
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::add(const ElemType & elem) {
+	int index = lowerBound(elem);
+	if (index < numUsed && cmpFn(elements[index], elem) == 0) {
+		elements[index] = elem;
+		return;
+	}
+	ensureCapacity(numUsed + 1);
+	for (int i = numUsed; i > index; i--) {
+		elements[i] = elements[i - 1];
+	}
+	elements[index] = elem;
+	numUsed++;
+	timestamp++;
+}
+
+/*
+ * Implementation notes: addAll
+ * ----------------------------
+ * The new elements are copied into a scratch array, sorted, and
+ * stripped of duplicates.  The sorted run is then merged with the
+ * existing elements by mergeSorted.
+ */
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::addAll(const ElemType array[], int n) {
+	if (n < 0) Error("addAll: negative element count");
+	if (n == 0) return;
+	ElemType *added = new ElemType[n];
+	for (int i = 0; i < n; i++) {
+		added[i] = array[i];
+	}
+	int nAdded = sortAndRemoveDuplicates(added, n);
+	mergeSorted(added, nAdded);
+	delete[] added;
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::addAll(Vector<ElemType> & elems) {
+	int n = elems.size();
+	if (n == 0) return;
+	ElemType *array = new ElemType[n];
+	for (int i = 0; i < n; i++) {
+		array[i] = elems[i];
+	}
+	addAll(array, n);
+	delete[] array;
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::remove(const ElemType & elem) {
+	int index = lowerBound(elem);
+	if (index == numUsed || cmpFn(elements[index], elem) != 0) return;
+	for (int i = index; i < numUsed - 1; i++) {
+		elements[i] = elements[i + 1];
+	}
+	numUsed--;
+	timestamp++;
+}
+
+template <typename ElemType, typename Comparator>
+bool FlatSet<ElemType, Comparator>::contains(const ElemType & elem) {
+	return find(elem) != NULL;
+}
+
+template <typename ElemType, typename Comparator>
+ElemType *FlatSet<ElemType, Comparator>::find(const ElemType & elem) {
+	int index = lowerBound(elem);
+	if (index == numUsed || cmpFn(elements[index], elem) != 0) return NULL;
+	return &elements[index];
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::clear() {
+	delete[] elements;
+	elements = NULL;
+	numAllocated = numUsed = 0;
+	timestamp++;
+}
+
+/*
+ * Implementation notes: Set operations
+ * ------------------------------------
+ * Because both sets are sorted, each of these operations can walk
+ * the two element arrays in step, advancing whichever side holds the
+ * smaller element, in the same way as the merge step of mergesort.
+ * The intersectWith and subtract methods only ever remove elements,
+ * so they compact the receiver's array in place; unionWith builds
+ * the result in a new array.
+ */
+
+template <typename ElemType, typename Comparator>
+bool FlatSet<ElemType, Comparator>::equals(FlatSet & otherSet) {
+	checkCmpFn(otherSet, "Equals");
+	if (numUsed != otherSet.numUsed) return false;
+	for (int i = 0; i < numUsed; i++) {
+		if (cmpFn(elements[i], otherSet.elements[i]) != 0) return false;
+	}
+	return true;
+}
+
+template <typename ElemType, typename Comparator>
+bool FlatSet<ElemType, Comparator>::isSubsetOf(FlatSet & otherSet) {
+	checkCmpFn(otherSet, "isSubsetOf");
+	if (numUsed > otherSet.numUsed) return false;
+	int j = 0;
+	for (int i = 0; i < numUsed; i++) {
+		while (j < otherSet.numUsed
+		       && cmpFn(otherSet.elements[j], elements[i]) < 0) {
+			j++;
+		}
+		if (j == otherSet.numUsed) return false;
+		if (cmpFn(otherSet.elements[j], elements[i]) != 0) return false;
+		j++;
+	}
+	return true;
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::unionWith(FlatSet & otherSet) {
+	checkCmpFn(otherSet, "unionWith");
+	if (this == &otherSet || otherSet.numUsed == 0) return;
+	mergeSorted(otherSet.elements, otherSet.numUsed);
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::intersectWith(FlatSet & otherSet) {
+	checkCmpFn(otherSet, "intersectWith");
+	int j = 0, k = 0;
+	for (int i = 0; i < numUsed; i++) {
+		while (j < otherSet.numUsed
+		       && cmpFn(otherSet.elements[j], elements[i]) < 0) {
+			j++;
+		}
+		if (j == otherSet.numUsed) break;
+		if (cmpFn(otherSet.elements[j], elements[i]) == 0) {
+			if (k != i) elements[k] = elements[i];
+			k++;
+		}
+	}
+	if (k != numUsed) {
+		numUsed = k;
+		timestamp++;
+	}
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::subtract(FlatSet & otherSet) {
+	checkCmpFn(otherSet, "subtract");
+	if (this == &otherSet) {
+		clear();
+		return;
+	}
+	int j = 0, k = 0;
+	for (int i = 0; i < numUsed; i++) {
+		while (j < otherSet.numUsed
+		       && cmpFn(otherSet.elements[j], elements[i]) < 0) {
+			j++;
+		}
+		if (j == otherSet.numUsed
+		    || cmpFn(otherSet.elements[j], elements[i]) != 0) {
+			if (k != i) elements[k] = elements[i];
+			k++;
+		}
+	}
+	if (k != numUsed) {
+		numUsed = k;
+		timestamp++;
+	}
+}
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::mapAll(void (*fn)(ElemType)) {
+	long t0 = timestamp;
+	for (int i = 0; i < numUsed; i++) {
+		fn(elements[i]);
+		if (timestamp != t0) {
+			Error("mapAll: FlatSet structure changed during mapping");
+		}
+	}
+}
+
+template <typename ElemType, typename Comparator>
+template <typename ClientDataType>
+void FlatSet<ElemType, Comparator>::mapAll(void (*fn)(ElemType,
+                                                      ClientDataType &),
+                                           ClientDataType & data) {
+	long t0 = timestamp;
+	for (int i = 0; i < numUsed; i++) {
+		fn(elements[i], data);
+		if (timestamp != t0) {
+			Error("mapAll: FlatSet structure changed during mapping");
+		}
+	}
+}
+
+template <typename ElemType, typename Comparator>
+const FlatSet<ElemType, Comparator> &
+      FlatSet<ElemType, Comparator>::operator=(const FlatSet & rhs) {
+	if (this != &rhs) {
+		delete[] elements;
+		copyInternalData(rhs);
+		timestamp = 0L;
+	}
+	return *this;
+}
+
+template <typename ElemType, typename Comparator>
+FlatSet<ElemType, Comparator>::FlatSet(const FlatSet & rhs)
+                                                     : cmpFn(rhs.cmpFn) {
+	copyInternalData(rhs);
+	timestamp = 0L;
+}
+
+/*
+ * FlatSet::Iterator class implementation
+ * --------------------------------------
+ * The Iterator for FlatSet maintains a pointer to the original set and
+ * an index into its array that identifies the next element to return.
+ */
+
+template <typename ElemType, typename Comparator>
+FlatSet<ElemType, Comparator>::Iterator::Iterator() {
+	sp = NULL;
+}
+
+template <typename ElemType, typename Comparator>
+typename FlatSet<ElemType, Comparator>::Iterator
+         FlatSet<ElemType, Comparator>::iterator() {
+	return Iterator(this);
+}
+
+template <typename ElemType, typename Comparator>
+FlatSet<ElemType, Comparator>::Iterator::Iterator(FlatSet *setptr) {
+	sp = setptr;
+	curIndex = 0;
+	timestamp = sp->timestamp;
+}
+
+template <typename ElemType, typename Comparator>
+bool FlatSet<ElemType, Comparator>::Iterator::hasNext() {
+	if (sp == NULL) Error("hasNext called on uninitialized iterator");
+	if (timestamp != sp->timestamp) {
+		Error("FlatSet structure has been modified");
+	}
+	return curIndex < sp->numUsed;
+}
+
+template <typename ElemType, typename Comparator>
+ElemType FlatSet<ElemType, Comparator>::Iterator::next() {
+	if (sp == NULL) Error("next called on uninitialized iterator");
+	if (!hasNext()) {
+		Error("Attempt to get next from iterator"
+		      " where hasNext() is false");
+	}
+	return sp->elements[curIndex++];
+}
+
+template <typename ElemType, typename Comparator>
+ElemType FlatSet<ElemType, Comparator>::foreachHook(FE_State & fe) {
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("FlatSet", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
+	}
+	if (((Iterator *) fe.iter)->hasNext()) {
+		fe.state = 1;
+		return ((Iterator *) fe.iter)->next();
+	} else {
+		fe.state = 2;
+		return ElemType();
+	}
+}
+
+/*
+ * Private method: lowerBound
+ * Usage: index = lowerBound(elem);
+ * --------------------------------
+ * Returns the index of the first element that is not less than elem,
+ * or numUsed if there is none.  The loop halves the candidate range
+ * on every pass without an early exit, and the choice of which half
+ * to keep is written as a conditional expression rather than an if
+ * statement.  That lets the compiler use a conditional move instead
+ * of a branch, which avoids the mispredictions that a conventional
+ * binary search suffers on random lookups.
+ */
+
+template <typename ElemType, typename Comparator>
+int FlatSet<ElemType, Comparator>::lowerBound(const ElemType & elem) {
+	if (numUsed == 0) return 0;
+	const ElemType *base = elements;
+	int n = numUsed;
+	while (n > 1) {
+		int half = n / 2;
+		base = (cmpFn(base[half], elem) < 0) ? base + half : base;
+		n -= half;
+	}
+	return (base - elements) + (cmpFn(*base, elem) < 0);
+}
+
+/*
+ * Private method: ensureCapacity
+ * Usage: ensureCapacity(n);
+ * -------------------------
+ * Makes sure the array has room for at least n elements, doubling
+ * its size as needed and copying all existing values.
+ */
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::ensureCapacity(int n) {
+	if (n <= numAllocated) return;
+	int newSize = (numAllocated == 0 ? 10 : numAllocated*2);
+	if (newSize < n) newSize = n;
+	INSTRUMENT_EVENT("FlatSet", GrowEvent, 0);
+	INSTRUMENT_EVENT("FlatSet", AllocationEvent, newSize * sizeof(ElemType));
+	ElemType *newArray = new ElemType[newSize];
+	for (int i = 0; i < numUsed; i++) {
+		newArray[i] = elements[i];
+	}
+	delete[] elements;
+	elements = newArray;
+	numAllocated = newSize;
+}
+
+/*
+ * Private method: sortAndRemoveDuplicates
+ * Usage: n = sortAndRemoveDuplicates(array, n);
+ * ---------------------------------------------
+ * Sorts the first n elements of the array and removes duplicates,
+ * returning the number of distinct elements left at the front of the
+ * array.  The sort is stable so that the last copy of each element
+ * is the one kept, as it would be after a sequence of add calls.
+ */
+
+template <typename ElemType, typename Comparator>
+int FlatSet<ElemType, Comparator>::sortAndRemoveDuplicates(ElemType *array,
+                                                           int n) {
+	lessT less(cmpFn);
+	std::stable_sort(array, array + n, less);
+	int k = 0;
+	for (int i = 0; i < n; i++) {
+		if (k > 0 && cmpFn(array[k - 1], array[i]) == 0) {
+			array[k - 1] = array[i];
+		} else {
+			if (k != i) array[k] = array[i];
+			k++;
+		}
+	}
+	return k;
+}
+
+/*
+ * Private method: mergeSorted
+ * Usage: mergeSorted(added, nAdded);
+ * ----------------------------------
+ * Merges a sorted array with no duplicates into the elements, building
+ * the result in a new array that becomes the new element array.  The
+ * merge takes the new copy of any element that appears in both, which
+ * matches the overwriting behavior of add.
+ */
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::mergeSorted(const ElemType *added,
+                                                int nAdded) {
+	ElemType *merged = new ElemType[numUsed + nAdded];
+	int i = 0, j = 0, k = 0;
+	while (i < numUsed && j < nAdded) {
+		int cmp = cmpFn(elements[i], added[j]);
+		if (cmp < 0) {
+			merged[k++] = elements[i++];
+		} else {
+			if (cmp == 0) i++;
+			merged[k++] = added[j++];
+		}
+	}
+	while (i < numUsed) merged[k++] = elements[i++];
+	while (j < nAdded) merged[k++] = added[j++];
+	delete[] elements;
+	elements = merged;
+	numAllocated = numUsed + nAdded;
+	numUsed = k;
+	timestamp++;
+}
+
+/*
+ * Private method: copyInternalData
+ * --------------------------------
+ * Common code factored out of the copy constructor and operator= to
+ * copy the contents from the other set.
+ */
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::copyInternalData(const FlatSet & other) {
+	INSTRUMENT_EVENT("FlatSet", CopyEvent, 0);
+	INSTRUMENT_EVENT("FlatSet", AllocationEvent, other.numUsed * sizeof(ElemType));
+	elements = (other.numUsed == 0) ? NULL : new ElemType[other.numUsed];
+	for (int i = 0; i < other.numUsed; i++) {
+		elements[i] = other.elements[i];
+	}
+	numUsed = numAllocated = other.numUsed;
+	cmpFn = other.cmpFn;
+}
+
+/*
+ * Private method: checkCmpFn
+ * --------------------------
+ * Raises an error if the other set uses a different comparison
+ * function, in which case the two orderings cannot be merged.
+ */
+
+template <typename ElemType, typename Comparator>
+void FlatSet<ElemType, Comparator>::checkCmpFn(FlatSet & otherSet,
+                                               const char *msg) {
+	if (cmpFn != otherSet.cmpFn) {
+		Error(string(msg) + ": sets have different comparison functions");
+	}
+}
+
+#endif
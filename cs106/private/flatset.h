@@ -0,0 +1,71 @@
+/*
+ * File: private/flatset.h
+ * -----------------------------------------------------
+ * This file contains the private section of the flatset.h interface.
+ * This portion of the class definition is taken out of the flatset.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+public:
+
+/*
+ * Class: FlatSet<ElemType, Comparator>::Iterator
+ * ----------------------------------------------
+ * This interface defines a nested class within the FlatSet template
+ * that provides iterator access to the FlatSet contents.
+ */
+	class Iterator : public FE_Iterator {
+	public:
+		Iterator();
+		bool hasNext();
+		ElemType next();
+
+	private:
+		Iterator(FlatSet *setptr);
+		FlatSet *sp;
+		int curIndex;
+		long timestamp;
+		friend class FlatSet;
+	};
+	friend class Iterator;
+	ElemType foreachHook(FE_State & _fe);
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return sets by value
+ * and assign from one set to another. The entire contents of
+ * the set, including all elements, are copied.
+ */
+	const FlatSet & operator=(const FlatSet & rhs);
+	FlatSet(const FlatSet & rhs);
+
+private:
+
+/*
+ * Class: lessT
+ * ------------
+ * Adapts the set's comparator to the "less than"
+ * predicate expected by the sorting functions in <algorithm>.
+ */
+	struct lessT {
+		lessT(Comparator cmp) : cmpFn(cmp) { }
+		Comparator cmpFn;
+		bool operator()(const ElemType & one, const ElemType & two) const {
+			return cmpFn(one, two) < 0;
+		}
+	};
+
+	ElemType *elements;
+	int numAllocated, numUsed;
+	long timestamp;
+	Comparator cmpFn;
+
+	int lowerBound(const ElemType & elem);
+	void ensureCapacity(int n);
+	int sortAndRemoveDuplicates(ElemType *array, int n);
+	void mergeSorted(const ElemType *added, int nAdded);
+	void copyInternalData(const FlatSet & other);
+	void checkCmpFn(FlatSet & otherSet, const char *msg);
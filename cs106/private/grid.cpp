@@ -14,15 +14,23 @@
  * ---------------------------
  * The Grid is internally managed as a dynamic array of elements.  The array
  * itself is one-dimensional, the logical separation into rows and columns
- * is done manually.  The layout is in row-major order, which is to say that
- * the first entire row is laid out contiguously, followed by the entire
- * next row and so on. All access is bounds-checked for safety.
+ * is done manually.  The default layout is in row-major order, which is to
+ * say that the first entire row is laid out contiguously, followed by the
+ * entire next row and so on.  In the tiled layout, the array is instead a
+ * sequence of TILE_SIZE x TILE_SIZE tiles in row-major order, each of which
+ * is itself stored in row-major order.  All access through getAt, setAt,
+ * and the subscript operators is bounds-checked for safety; rowSpan checks
+ * only the row.  These checks are left out if GRID_CHECKS is 0, as
+ * described in private/checks.h.
  */
 
 template <typename ElemType>
 Grid<ElemType>::Grid() {
 	nRows = 0;
 	nCols = 0;
+	layout = RowMajorLayout;
+	tilesPerRow = 0;
+	setStrides();
 	timestamp = 0L;
 	elements = NULL;
 }
@@ -30,6 +38,19 @@ Grid<ElemType>::Grid() {
 template <typename ElemType>
 Grid<ElemType>::Grid(int numRows, int numCols) {
 	elements = NULL;
+	nRows = nCols = 0;
+	layout = RowMajorLayout;
+	tilesPerRow = 0;
+	timestamp = 0L;
+	resize(numRows, numCols);
+}
+
+template <typename ElemType>
+Grid<ElemType>::Grid(int numRows, int numCols, layoutOptionT layout) {
+	elements = NULL;
+	nRows = nCols = 0;
+	this->layout = layout;
+	tilesPerRow = 0;
 	timestamp = 0L;
 	resize(numRows, numCols);
 }
@@ -50,16 +71,49 @@ int Grid<ElemType>::numCols() {
 }
 
 template <typename ElemType>
-void Grid<ElemType>::resize(int numRows, int numCols) {
+typename Grid<ElemType>::layoutOptionT Grid<ElemType>::getLayout() {
+	return layout;
+}
+
+/*
+ * Implementation notes: resize
+ * ----------------------------
+ * When retainContents is true, the old array is kept until the
+ * overlapping region has been copied into the new one.  The copy
+ * runs row by row, so that in the row-major layout the inner loop
+ * moves contiguous elements.
+ */
+
+template <typename ElemType>
+void Grid<ElemType>::resize(int numRows, int numCols, bool retainContents) {
 	if (numRows < 0 || numCols < 0) {
 		Error("Attempt to resize grid to invalid size ("
 		      + IntegerToString(numRows) + ", "
 		      + IntegerToString(numCols) + ")");
 	}
-	if (elements) delete[] elements;
+	ElemType *oldElements = elements;
+	int oldRows = nRows;
+	int oldCols = nCols;
+	int oldTilesPerRow = tilesPerRow;
 	nRows = numRows;
 	nCols = numCols;
-	elements = new ElemType[nRows * nCols];
+	tilesPerRow = (nCols + TILE_MASK) >> TILE_SHIFT;
+	setStrides();
+	INSTRUMENT_EVENT("Grid", AllocationEvent, storageSize() * sizeof(ElemType));
+	elements = new ElemType[storageSize()];
+	if (retainContents && oldElements != NULL) {
+		int copyRows = (oldRows < nRows) ? oldRows : nRows;
+		int copyCols = (oldCols < nCols) ? oldCols : nCols;
+		for (int row = 0; row < copyRows; row++) {
+			for (int col = 0; col < copyCols; col++) {
+				int oldIndex = (layout == RowMajorLayout)
+				             ? row * oldCols + col
+				             : tiledIndex(row, col, oldTilesPerRow);
+				elements[indexOf(row, col)] = oldElements[oldIndex];
+			}
+		}
+	}
+	delete[] oldElements;
 	timestamp++;
 }
 
@@ -80,15 +134,58 @@ bool Grid<ElemType>::inBounds(int row, int col) {
 
 template <typename ElemType>
 ElemType &Grid<ElemType>::operator()(int row, int col) {
-	checkRange(row,col);
-	return elements[(row * nCols) + col];
+	if (GRID_CHECKS) checkRange(row, col);
+	return elements[indexOf(row, col)];
 }
 
 template <typename ElemType>
 typename Grid<ElemType>::GridRow Grid<ElemType>::operator[](int row) {
+	if (GRID_CHECKS) checkRow(row);
 	return GridRow(this, row);
 }
 
+template <typename ElemType>
+ElemType *Grid<ElemType>::rowSpan(int row) {
+	if (layout != RowMajorLayout) {
+		Error("rowSpan: grid does not use the row-major layout");
+	}
+	if (GRID_CHECKS) checkRow(row);
+	return elements + row * nCols;
+}
+
+/*
+ * Implementation notes: fill, count, sum
+ * --------------------------------------
+ * The fill method writes the entire array, including any padding in
+ * the edge tiles, which no other method ever reads.  The count and
+ * sum methods hand each contiguous run of real elements to one of
+ * the run functions in private/grid.h.  Each run function keeps its
+ * partial result in a local variable, so that the inner loop has no
+ * stores to memory and no early exits and can be vectorized.
+ */
+
+template <typename ElemType>
+void Grid<ElemType>::fill(ElemType value) {
+	int n = storageSize();
+	for (int i = 0; i < n; i++) {
+		elements[i] = value;
+	}
+}
+
+template <typename ElemType>
+int Grid<ElemType>::count(ElemType value) {
+	countRunT fn(value);
+	forEachRun(fn);
+	return fn.result;
+}
+
+template <typename ElemType>
+ElemType Grid<ElemType>::sum() {
+	sumRunT fn;
+	forEachRun(fn);
+	return fn.result;
+}
+
 template <typename ElemType>
 const Grid<ElemType> & Grid<ElemType>::operator=(const Grid & rhs) {
 	if (this != &rhs) {
@@ -105,6 +202,114 @@ Grid<ElemType>::Grid(const Grid & rhs) {
 	timestamp = 0L;
 }
 
+/*
+ * Implementation notes: indexOf, rowOffset, setStrides
+ * ----------------------------------------------------
+ * Element access must not test the layout, since that test would be
+ * made on every access.  Instead, setStrides records the layout as a
+ * few numbers whenever the size or layout changes, and indexOf uses
+ * the same arithmetic for both layouts.  The index of (row, col) is
+ * rowOffset(row) + col + (col >> TILE_SHIFT) * colGap, where
+ *
+ *      rowOffset(row) = (row >> rowShift) * rowStride
+ *                       + ((row & rowMask) << TILE_SHIFT)
+ *
+ * In the row-major layout, rowShift, rowMask and colGap are all 0 and
+ * rowStride is nCols, which reduces the index to row * nCols + col.
+ * In the tiled layout, rowStride is the size of a whole row of tiles,
+ * and colGap skips the other rows of each tile that the column passes.
+ * GridRow computes rowOffset once, when it is created.
+ */
+
+template <typename ElemType>
+int Grid<ElemType>::indexOf(int row, int col) {
+	return rowOffset(row) + col + (col >> TILE_SHIFT) * colGap;
+}
+
+template <typename ElemType>
+int Grid<ElemType>::rowOffset(int row) {
+	return (row >> rowShift) * rowStride + ((row & rowMask) << TILE_SHIFT);
+}
+
+template <typename ElemType>
+void Grid<ElemType>::setStrides() {
+	if (layout == RowMajorLayout) {
+		rowShift = rowMask = colGap = 0;
+		rowStride = nCols;
+	} else {
+		rowShift = TILE_SHIFT;
+		rowMask = TILE_MASK;
+		rowStride = tilesPerRow * TILE_AREA;
+		colGap = TILE_AREA - TILE_SIZE;
+	}
+}
+
+template <typename ElemType>
+int Grid<ElemType>::tiledIndex(int row, int col, int tilesPerRow) {
+	int tile = (row >> TILE_SHIFT) * tilesPerRow + (col >> TILE_SHIFT);
+	return (tile * TILE_AREA) + ((row & TILE_MASK) << TILE_SHIFT)
+	       + (col & TILE_MASK);
+}
+
+/*
+ * Private method: storageSize
+ * Usage: int n = storageSize();
+ * -----------------------------
+ * Returns the number of elements in the array, which in the
+ * tiled layout includes the padding in the edge tiles.
+ */
+
+template <typename ElemType>
+int Grid<ElemType>::storageSize() {
+	if (layout == RowMajorLayout) return nRows * nCols;
+	int tilesPerCol = (nRows + TILE_MASK) >> TILE_SHIFT;
+	return tilesPerRow * tilesPerCol * TILE_AREA;
+}
+
+/*
+ * Private method: forEachRun
+ * Usage: forEachRun(fn);
+ * ----------------------
+ * Calls fn(run, n) for a sequence of contiguous runs of elements
+ * that together cover the grid exactly once, skipping any padding.
+ * A row-major grid is a single run.  In the tiled layout, each tile
+ * is a single run unless it extends past the right edge of the grid,
+ * in which case each of its rows is a separate run.
+ */
+
+template <typename ElemType>
+template <typename RunFn>
+void Grid<ElemType>::forEachRun(RunFn & fn) {
+	if (layout == RowMajorLayout) {
+		fn(elements, nRows * nCols);
+		return;
+	}
+	ElemType *tile = elements;
+	for (int row0 = 0; row0 < nRows; row0 += TILE_SIZE) {
+		int rows = (nRows - row0 < TILE_SIZE) ? nRows - row0 : TILE_SIZE;
+		for (int col0 = 0; col0 < nCols; col0 += TILE_SIZE) {
+			int cols = (nCols - col0 < TILE_SIZE) ? nCols - col0 : TILE_SIZE;
+			if (cols == TILE_SIZE) {
+				fn(tile, rows * TILE_SIZE);
+			} else {
+				for (int r = 0; r < rows; r++) {
+					fn(tile + (r << TILE_SHIFT), cols);
+				}
+			}
+			tile += TILE_AREA;
+		}
+	}
+}
+
+template <typename ElemType>
+void Grid<ElemType>::checkRow(int row) {
+	if (row < 0 || row >= numRows()) {
+		Error("Attempt to access row " + IntegerToString(row)
+		      + " in a grid with " + IntegerToString(numRows())
+		      + " rows");
+	}
+}
+
 template <typename ElemType>
 void Grid<ElemType>::checkRange(int row, int col) {
 	if (row < 0 || row >= numRows() || col < 0 || col >= numCols()) {
@@ -119,20 +324,35 @@ template <typename ElemType>
 void Grid<ElemType>::copyContentsFrom(const Grid & other) {
 	nRows = other.nRows;
 	nCols = other.nCols;
-	elements = new ElemType[nRows * nCols];
-	for (int i = 0; i < nRows * nCols; i++) {
+	layout = other.layout;
+	tilesPerRow = other.tilesPerRow;
+	setStrides();
+	int n = storageSize();
+	INSTRUMENT_EVENT("Grid", CopyEvent, 0);
+	INSTRUMENT_EVENT("Grid", AllocationEvent, n * sizeof(ElemType));
+	elements = new ElemType[n];
+	for (int i = 0; i < n; i++) {
 		elements[i] = other.elements[i];
 	}
 }
 
+/*
+ * Implementation notes: mapAll
+ * ----------------------------
+ * Both versions of mapAll visit the elements in row-major order,
+ * whatever the layout of the grid.
+ */
+
 template <typename ElemType>
 void Grid<ElemType>::mapAll(void (*fn)(ElemType)) {
 	long t0 = timestamp;
-	for (int i = 0; i < nRows * nCols; i++) {
-		if (timestamp != t0) {
-			Error("Grid structure has been modified");
+	for (int row = 0; row < nRows; row++) {
+		for (int col = 0; col < nCols; col++) {
+			if (GRID_CHECKS && timestamp != t0) {
+				Error("Grid structure has been modified");
+			}
+			fn(elements[indexOf(row, col)]);
 		}
-		fn(elements[i]);
 	}
 }
 
@@ -141,11 +361,13 @@ template <typename ClientDataType>
 void Grid<ElemType>::mapAll(void (*fn)(ElemType, ClientDataType&),
                             ClientDataType & data) {
 	long t0 = timestamp;
-	for (int i = 0; i < nRows * nCols; i++) {
-		if (timestamp != t0) {
-			Error("Grid structure has been modified");
+	for (int row = 0; row < nRows; row++) {
+		for (int col = 0; col < nCols; col++) {
+			if (GRID_CHECKS && timestamp != t0) {
+				Error("Grid structure has been modified");
+			}
+			fn(elements[indexOf(row, col)], data);
 		}
-		fn(elements[i], data);
 	}
 }
 
@@ -177,7 +399,7 @@ Grid<ElemType>::Iterator::Iterator(Grid *gridRef) {
 template <typename ElemType>
 bool Grid<ElemType>::Iterator::hasNext() {
 	if (gp == NULL) Error("hasNext called on uninitialized iterator");
-	if (timestamp != gp->timestamp) {
+	if (GRID_CHECKS && timestamp != gp->timestamp) {
 		Error("Grid structure has been modified");
 	}
 	return curRow < gp->numRows() && curCol < gp->numCols();
@@ -196,12 +418,15 @@ ElemType Grid<ElemType>::Iterator::next() {
 		curCol = 0;
 		curRow++;
 	}
-	return (*gp)(row, col);
+	return gp->elements[gp->indexOf(row, col)];
 }
 
 template <typename ElemType>
 ElemType Grid<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("Grid", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
@@ -211,7 +436,14 @@ ElemType Grid<ElemType>::foreachHook(FE_State & fe) {
 	}
 }
 
-/* GridRow implementation */
+/*
+ * GridRow implementation
+ * ----------------------
+ * The row is checked once by Grid::operator[] when the GridRow is
+ * created, so GridRow::operator[] checks only the column.  The GridRow
+ * also keeps a pointer to the start of its row and its own copy of
+ * colGap, so that finding a column needs only the column term of indexOf.
+ */
 
 template <typename ElemType>
 Grid<ElemType>::GridRow::GridRow() {
@@ -222,11 +454,16 @@ template <typename ElemType>
 Grid<ElemType>::GridRow::GridRow(Grid *gridRef, int index) {
 	gp = gridRef;
 	row = index;
+	base = gp->elements + gp->rowOffset(row);
+	colGap = gp->colGap;
 }
 
 template <typename ElemType>
 ElemType & Grid<ElemType>::GridRow::operator[](int col) {
-	return (*gp)(row,col);
+	if (GRID_CHECKS && (col < 0 || col >= gp->nCols)) {
+		gp->checkRange(row, col);
+	}
+	return base[col + (col >> TILE_SHIFT) * colGap];
 }
 
 #endif
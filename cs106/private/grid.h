@@ -35,6 +35,8 @@ public:
 		GridRow(Grid *gridRef, int index);
 		Grid *gp;
 		int row;
+		ElemType *base;
+		int colGap;
 		friend class Grid;
 	};
 	friend class GridRow;
@@ -80,9 +82,63 @@ public:
 
 private:
 
+/*
+ * Tiled layout constants
+ * ----------------------
+ * Tiles are TILE_SIZE x TILE_SIZE elements, where TILE_SIZE is
+ * 1 << TILE_SHIFT.  The tiles along the bottom and right edges are
+ * padded out to full size.
+ */
+	static const int TILE_SHIFT = 3;
+	static const int TILE_SIZE = 1 << TILE_SHIFT;
+	static const int TILE_MASK = TILE_SIZE - 1;
+	static const int TILE_AREA = TILE_SIZE * TILE_SIZE;
+
+/*
+ * Run functions for the whole-grid kernels
+ * ----------------------------------------
+ * Each of these structures processes one contiguous run of elements
+ * for forEachRun, accumulating its result in a data member.
+ */
+	struct countRunT {
+		countRunT(ElemType v) : value(v), result(0) { }
+		ElemType value;
+		int result;
+		void operator()(const ElemType *run, int n) {
+			int k = 0;
+			for (int i = 0; i < n; i++) {
+				k += (run[i] == value);
+			}
+			result += k;
+		}
+	};
+
+	struct sumRunT {
+		sumRunT() : result() { }
+		ElemType result;
+		void operator()(const ElemType *run, int n) {
+			ElemType total = ElemType();
+			for (int i = 0; i < n; i++) {
+				total += run[i];
+			}
+			result += total;
+		}
+	};
+
 	ElemType *elements;
 	int nRows, nCols;
+	layoutOptionT layout;
+	int tilesPerRow;
+	int rowShift, rowMask, rowStride, colGap;
 	long timestamp;
 
+	int indexOf(int row, int col);
+	int rowOffset(int row);
+	void setStrides();
+	static int tiledIndex(int row, int col, int tilesPerRow);
+	int storageSize();
+	template <typename RunFn>
+	void forEachRun(RunFn & fn);
 	void checkRange(int row, int col);
+	void checkRow(int row);
 	void copyContentsFrom(const Grid & other);
@@ -0,0 +1,488 @@
+/*
+ * File: private/hashmap.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the hashmap.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _hashmap_h
+
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASHMAP_USE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/*
+ * Implementation notes: HashMap class
+ * -----------------------------------
+ * In this implementation, the entries are stored in a single flat
+ * array of slots using open addressing, so that no memory is allocated
+ * per entry and a lookup touches as few cache lines as possible.
+ * Alongside the slots is an array of control bytes, one per slot.
+ * A control byte is CTRL_EMPTY for a slot that has never been used,
+ * CTRL_DELETED for a slot whose entry has been removed, and otherwise
+ * holds the low seven bits of the hash code of the key in the slot.
+ *
+ * The slots are divided into groups of GROUP_SIZE.  The high bits of
+ * the hash code select a starting group, and a lookup compares the
+ * low seven bits against all of the control bytes in the group at
+ * once (using SSE2 instructions where they are available).  Only the
+ * slots whose control bytes match are compared against the key, which
+ * almost never happens for the wrong key.  If the key is not in that
+ * group and the group has an empty slot, the key is not in the table;
+ * otherwise the search moves on to the next group in a triangular
+ * probe sequence, which visits every group because the number of
+ * groups is a power of two.  The table is enlarged when it becomes
+ * seven-eighths full, counting the deleted slots.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+HashMap<KeyType, ValueType, HashFn>::HashMap(int sizeHint) {
+	if (sizeHint < 0) Error("Negative sizeHint given to HashMap constructor");
+	int nSlots = GROUP_SIZE;
+	while (nSlots / 8 * 7 < sizeHint) {
+		nSlots *= 2;
+	}
+	initTable(nSlots);
+	timestamp = 0L;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+HashMap<KeyType, ValueType, HashFn>::~HashMap() {
+	deleteTable();
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+int HashMap<KeyType, ValueType, HashFn>::size() {
+	return numEntries;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+bool HashMap<KeyType, ValueType, HashFn>::isEmpty() {
+	return numEntries == 0;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::put(const KeyType & key,
+                                              const ValueType & value) {
+	(*this)[key] = value;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+void HashMap<KeyType, ValueType, HashFn>::remove(const KeyLike & key) {
+	int index = findSlot(key, hash(key));
+	if (index != -1) {
+		ctrl[index] = CTRL_DELETED;
+		slots[index] = slotT();
+		numEntries--;
+		numDeleted++;
+	}
+	timestamp++;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::clear() {
+	deleteTable();
+	initTable(GROUP_SIZE);
+	timestamp++;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+bool HashMap<KeyType, ValueType, HashFn>::containsKey(const KeyLike & key) {
+	return findSlot(key, hash(key)) != -1;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+ValueType *HashMap<KeyType, ValueType, HashFn>::find(const KeyLike & key) {
+	int index = findSlot(key, hash(key));
+	if (index == -1) return NULL;
+	return &slots[index].value;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+ValueType HashMap<KeyType, ValueType, HashFn>::get(const KeyLike & key) {
+	int index = findSlot(key, hash(key));
+	if (index == -1) {
+		Error("Attempt to get value for key which is not contained in map.");
+	}
+	return slots[index].value;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+ValueType & HashMap<KeyType, ValueType, HashFn>::operator[](const KeyLike & key) {
+	unsigned long hashCode = hash(key);
+	int index = findSlot(key, hashCode);
+	if (index == -1) {
+		if ((numEntries + numDeleted + 1) * 8 > capacity * 7) {
+			rehash(numDeleted > numEntries / 2 ? capacity : capacity * 2);
+		}
+		index = findInsertSlot(hashCode);
+		if (ctrl[index] == CTRL_DELETED) numDeleted--;
+		ctrl[index] = (signed char) (hashCode & 0x7F);
+		slots[index].key = key;
+		slots[index].value = ValueType();
+		numEntries++;
+		timestamp++;
+	}
+	return slots[index].value;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+const HashMap<KeyType, ValueType, HashFn> &
+      HashMap<KeyType, ValueType, HashFn>::operator=(const HashMap & rhs) {
+	if (this != &rhs) {
+		deleteTable();
+		copyOtherEntries(rhs);
+		timestamp = 0L;
+	}
+	return *this;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+HashMap<KeyType, ValueType, HashFn>::HashMap(const HashMap & rhs) {
+	copyOtherEntries(rhs);
+	timestamp = 0L;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename ClientData>
+void HashMap<KeyType, ValueType, HashFn>::mapAll(void (*fn)(KeyType, ValueType,
+                                                            ClientData &),
+                                                 ClientData & data) {
+	long t0 = timestamp;
+	for (int i = 0; i < capacity; i++) {
+		if (ctrl[i] >= 0) {
+			fn(slots[i].key, slots[i].value, data);
+			if (t0 != timestamp) {
+				Error("mapAll: HashMap structure changed");
+			}
+		}
+	}
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::mapAll(void (*fn)(KeyType key,
+                                                            ValueType value)) {
+	long t0 = timestamp;
+	for (int i = 0; i < capacity; i++) {
+		if (ctrl[i] >= 0) {
+			fn(slots[i].key, slots[i].value);
+			if (t0 != timestamp) {
+				Error("mapAll: HashMap structure changed");
+			}
+		}
+	}
+}
+
+/*
+ * Private method: hash
+ * Usage: hashCode = hash(key);
+ * ----------------------------
+ * This method applies the client's hash functor to key and then mixes
+ * the bits of the result, so that hash functions which leave the high
+ * or low bits unused (such as the identity on integers) still spread
+ * keys evenly over the groups and the seven-bit tags.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+unsigned long HashMap<KeyType, ValueType, HashFn>::hash(const KeyLike & key) {
+	unsigned long hashCode = hashFn(key);
+	hashCode ^= hashCode >> 16;
+	hashCode *= 0x45d9f3bUL;
+	hashCode ^= hashCode >> 16;
+	hashCode *= 0x45d9f3bUL;
+	hashCode ^= hashCode >> 16;
+	return hashCode;
+}
+
+/*
+ * Private method: findSlot
+ * Usage: index = findSlot(key, hashCode);
+ * ---------------------------------------
+ * This method returns the index of the slot containing key, or -1
+ * if the key is not in the table.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+template <typename KeyLike>
+int HashMap<KeyType, ValueType, HashFn>::findSlot(const KeyLike & key,
+                                                  unsigned long hashCode) {
+	int groupMask = capacity / GROUP_SIZE - 1;
+	int group = (int) (hashCode >> 7) & groupMask;
+	signed char tag = (signed char) (hashCode & 0x7F);
+	for (int probe = 1; probe <= groupMask + 1; probe++) {
+		int base = group * GROUP_SIZE;
+		unsigned int matches = matchTag(ctrl + base, tag);
+		while (matches != 0) {
+			int index = base + lowestBit(matches);
+			if (slots[index].key == key) return index;
+			matches &= matches - 1;
+		}
+		if (matchEmpty(ctrl + base) != 0) return -1;
+		group = (group + probe) & groupMask;
+	}
+	return -1;
+}
+
+/*
+ * Private method: findInsertSlot
+ * Usage: index = findInsertSlot(hashCode);
+ * ----------------------------------------
+ * This method returns the first empty or deleted slot in the probe
+ * sequence for hashCode.  The load factor guarantees that one exists.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+int HashMap<KeyType, ValueType, HashFn>::findInsertSlot(unsigned long hashCode) {
+	int groupMask = capacity / GROUP_SIZE - 1;
+	int group = (int) (hashCode >> 7) & groupMask;
+	for (int probe = 1; true; probe++) {
+		int base = group * GROUP_SIZE;
+		unsigned int available = matchEmptyOrDeleted(ctrl + base);
+		if (available != 0) return base + lowestBit(available);
+		group = (group + probe) & groupMask;
+	}
+}
+
+/*
+ * Private method: rehash
+ * Usage: rehash(nSlots);
+ * ----------------------
+ * This method moves every entry into a fresh table with nSlots slots.
+ * It is used both to enlarge the table and, when most of the used
+ * slots are tombstones, to clear those out at the same size.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::rehash(int nSlots) {
+	INSTRUMENT_EVENT("HashMap", RehashEvent, 0);
+	signed char *oldCtrl = ctrl;
+	slotT *oldSlots = slots;
+	int oldCapacity = capacity;
+	initTable(nSlots);
+	for (int i = 0; i < oldCapacity; i++) {
+		if (oldCtrl[i] >= 0) {
+			unsigned long hashCode = hash(oldSlots[i].key);
+			int index = findInsertSlot(hashCode);
+			ctrl[index] = (signed char) (hashCode & 0x7F);
+			slots[index] = oldSlots[i];
+			numEntries++;
+		}
+	}
+	delete[] oldCtrl;
+	delete[] oldSlots;
+	timestamp++;
+}
+
+/*
+ * Private method: initTable
+ * Usage: initTable(nSlots);
+ * -------------------------
+ * This method allocates an empty table of nSlots slots, which must be
+ * a power of two no smaller than GROUP_SIZE.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::initTable(int nSlots) {
+	capacity = nSlots;
+	INSTRUMENT_EVENT("HashMap", AllocationEvent,
+	                 capacity * (sizeof(signed char) + sizeof(slotT)));
+	ctrl = new signed char[capacity];
+	memset(ctrl, CTRL_EMPTY, capacity);
+	slots = new slotT[capacity];
+	numEntries = 0;
+	numDeleted = 0;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::deleteTable() {
+	delete[] ctrl;
+	delete[] slots;
+	ctrl = NULL;
+	slots = NULL;
+}
+
+/*
+ * Private method: copyOtherEntries
+ * Usage: copyOtherEntries(otherMap);
+ * ----------------------------------
+ * This method copies the table of the other map slot by slot.
+ * Because the copy has the same capacity, every entry lands in the
+ * same position and nothing needs to be rehashed.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::copyOtherEntries(const HashMap & other) {
+	capacity = other.capacity;
+	INSTRUMENT_EVENT("HashMap", CopyEvent, 0);
+	INSTRUMENT_EVENT("HashMap", AllocationEvent,
+	                 capacity * (sizeof(signed char) + sizeof(slotT)));
+	ctrl = new signed char[capacity];
+	memcpy(ctrl, other.ctrl, capacity);
+	slots = new slotT[capacity];
+	for (int i = 0; i < capacity; i++) {
+		if (ctrl[i] >= 0) slots[i] = other.slots[i];
+	}
+	numEntries = other.numEntries;
+	numDeleted = other.numDeleted;
+	hashFn = other.hashFn;
+}
+
+/*
+ * Implementation notes: group matching
+ * ------------------------------------
+ * These functions compare the GROUP_SIZE control bytes that begin at
+ * group against a value and return a bit mask with bit i set if the
+ * control byte at position i matches.  With SSE2, each takes a single
+ * compare and movemask instruction; otherwise the bytes are tested
+ * one at a time.  An empty or deleted byte is the only kind that is
+ * negative and less than -1, which is what matchEmptyOrDeleted tests.
+ */
+
+#ifdef HASHMAP_USE_SSE2
+
+template <typename KeyType, typename ValueType, typename HashFn>
+unsigned int HashMap<KeyType, ValueType, HashFn>::matchTag(const signed char *group,
+                                                           signed char tag) {
+	__m128i ctrlBytes = _mm_loadu_si128((const __m128i *) group);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrlBytes, _mm_set1_epi8(tag)));
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+unsigned int HashMap<KeyType, ValueType, HashFn>::matchEmpty(const signed char *group) {
+	__m128i ctrlBytes = _mm_loadu_si128((const __m128i *) group);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrlBytes,
+	                                        _mm_set1_epi8(CTRL_EMPTY)));
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+unsigned int HashMap<KeyType, ValueType, HashFn>::matchEmptyOrDeleted(const signed char *group) {
+	__m128i ctrlBytes = _mm_loadu_si128((const __m128i *) group);
+	return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), ctrlBytes));
+}
+
+#else
+
+template <typename KeyType, typename ValueType, typename HashFn>
+unsigned int HashMap<KeyType, ValueType, HashFn>::matchTag(const signed char *group,
+                                                           signed char tag) {
+	unsigned int mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++) {
+		if (group[i] == tag) mask |= 1U << i;
+	}
+	return mask;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+unsigned int HashMap<KeyType, ValueType, HashFn>::matchEmpty(const signed char *group) {
+	unsigned int mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++) {
+		if (group[i] == CTRL_EMPTY) mask |= 1U << i;
+	}
+	return mask;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+unsigned int HashMap<KeyType, ValueType, HashFn>::matchEmptyOrDeleted(const signed char *group) {
+	unsigned int mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++) {
+		if (group[i] < -1) mask |= 1U << i;
+	}
+	return mask;
+}
+
+#endif
+
+template <typename KeyType, typename ValueType, typename HashFn>
+int HashMap<KeyType, ValueType, HashFn>::lowestBit(unsigned int mask) {
+#if defined(__GNUC__)
+	return __builtin_ctz(mask);
+#else
+	int bit = 0;
+	while ((mask & 1) == 0) {
+		mask >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+/*
+ * HashMap::Iterator class implementation
+ * --------------------------------------
+ * The iterator walks the control bytes in order, stopping at each
+ * slot that holds an entry.
+ */
+
+template <typename KeyType, typename ValueType, typename HashFn>
+HashMap<KeyType, ValueType, HashFn>::Iterator::Iterator() {
+	mp = NULL;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+typename HashMap<KeyType, ValueType, HashFn>::Iterator
+         HashMap<KeyType, ValueType, HashFn>::iterator() {
+	return Iterator(this);
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+HashMap<KeyType, ValueType, HashFn>::Iterator::Iterator(HashMap *mapptr) {
+	mp = mapptr;
+	slotIndex = -1;
+	timestamp = mp->timestamp;
+	advanceToNextKey();
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+bool HashMap<KeyType, ValueType, HashFn>::Iterator::hasNext() {
+	if (mp == NULL) Error("hasNext called on uninitialized iterator");
+	if (timestamp != mp->timestamp) {
+		Error("HashMap structure has been modified");
+	}
+	return slotIndex < mp->capacity;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+KeyType HashMap<KeyType, ValueType, HashFn>::Iterator::next() {
+	if (mp == NULL) Error("next called on uninitialized iterator");
+	if (!hasNext()) {
+		Error("Attempt to get next from iterator"
+		      " where hasNext() is false");
+	}
+	KeyType result = mp->slots[slotIndex].key;
+	advanceToNextKey();
+	return result;
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+void HashMap<KeyType, ValueType, HashFn>::Iterator::advanceToNextKey() {
+	slotIndex++;
+	while (slotIndex < mp->capacity && mp->ctrl[slotIndex] < 0) {
+		slotIndex++;
+	}
+}
+
+template <typename KeyType, typename ValueType, typename HashFn>
+KeyType HashMap<KeyType, ValueType, HashFn>::foreachHook(FE_State & fe) {
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("HashMap", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
+	}
+	if (((Iterator *) fe.iter)->hasNext()) {
+		fe.state = 1;
+		return ((Iterator *) fe.iter)->next();
+	} else {
+		fe.state = 2;
+		return KeyType();
+	}
+}
+
+#endif
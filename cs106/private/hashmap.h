@@ -0,0 +1,89 @@
+/*
+ * File: private/hashmap.h
+ * -----------------------------------------------------
+ * This file contains the private section of the hashmap.h interface.
+ * This portion of the class definition is taken out of the hashmap.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+public:
+
+/*
+ * Class: HashMap<KeyType, ValueType>::Iterator
+ * --------------------------------------------
+ * This interface defines a nested class within the HashMap template
+ * that provides iterator access to the keys contained in the HashMap.
+ */
+	class Iterator : public FE_Iterator {
+	public:
+		Iterator();
+		bool hasNext();
+		KeyType next();
+
+	private:
+		Iterator(HashMap *mp);
+		HashMap *mp;
+		int slotIndex;
+		long timestamp;
+		void advanceToNextKey();
+		friend class HashMap;
+	};
+	friend class Iterator;
+	KeyType foreachHook(FE_State & _fe);
+
+/*
+ * Deep copying support
+ * --------------------
+ * This copy constructor and operator= are defined to make a
+ * deep copy, making it possible to pass/return maps by value
+ * and assign from one map to another. The entire contents of
+ * the map, including all entries, are copied. Each map
+ * entry is copied from the original map to the copy using
+ * assignment (operator=). Making copies is generally avoided
+ * because of the expense and thus, maps are typically passed by
+ * reference, however, when a copy is needed, these operations
+ * are supported.
+ */
+	const HashMap & operator=(const HashMap & rhs);
+	HashMap(const HashMap & rhs);
+
+private:
+
+/* Type definition for an entry in the table */
+	struct slotT {
+		KeyType key;
+		ValueType value;
+	};
+
+/* Constant definitions */
+	static const int GROUP_SIZE = 16;
+	static const signed char CTRL_EMPTY = -128;
+	static const signed char CTRL_DELETED = -2;
+
+/* Instance variables */
+	signed char *ctrl;    /* One control byte per slot                 */
+	slotT *slots;         /* Keys and values, parallel to ctrl         */
+	int capacity;         /* Number of slots, a power of two >= 16     */
+	int numEntries;       /* Number of slots holding an entry          */
+	int numDeleted;       /* Number of slots holding a tombstone       */
+	long timestamp;
+	HashFn hashFn;
+
+/* Private method prototypes */
+	void initTable(int nSlots);
+	void deleteTable();
+	void rehash(int nSlots);
+	void copyOtherEntries(const HashMap & other);
+	int findInsertSlot(unsigned long hashCode);
+
+	template <typename KeyLike>
+	int findSlot(const KeyLike & key, unsigned long hashCode);
+
+	template <typename KeyLike>
+	unsigned long hash(const KeyLike & key);
+
+	static unsigned int matchTag(const signed char *group, signed char tag);
+	static unsigned int matchEmpty(const signed char *group);
+	static unsigned int matchEmptyOrDeleted(const signed char *group);
+	static int lowestBit(unsigned int mask);
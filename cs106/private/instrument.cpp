@@ -0,0 +1,127 @@
+/*
+ * File: private/instrument.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the instrument.h interface.
+ * The functions are declared inline so that the code can live in the
+ * header, since instrumentation is not part of the precompiled library.
+ */
+
+#ifdef _instrument_h
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <utility>
+
+/*
+ * Implementation notes: instrument registry
+ * -----------------------------------------
+ * The counts live in a map from (container, site) pairs to arrays of
+ * counters, protected by a mutex.  The map is a function-local static
+ * inside an inline function, which gives the whole program a single
+ * copy no matter how many files include this header.  The pairs hold
+ * the name pointers passed to the macros and are compared by their
+ * characters, since the same literal may have a different address in
+ * each file.  The current site is a thread-local pointer, so that each
+ * thread charges its own site.
+ */
+
+const int N_INSTRUMENT_EVENTS = IteratorEvent + 1;
+
+struct instrumentCountsT {
+	long events[N_INSTRUMENT_EVENTS];
+	long long bytes;
+};
+
+struct instrumentKeyLessT {
+	bool operator()(const pair<const char *, const char *> & a,
+	                const pair<const char *, const char *> & b) const {
+		int cmp = strcmp(a.first, b.first);
+		if (cmp != 0) return cmp < 0;
+		return strcmp(a.second, b.second) < 0;
+	}
+};
+
+struct instrumentRegistryT {
+	std::mutex lock;
+	map<pair<const char *, const char *>, instrumentCountsT,
+	    instrumentKeyLessT> counts;
+};
+
+inline instrumentRegistryT & InstrumentRegistry() {
+	static instrumentRegistryT registry;
+	return registry;
+}
+
+inline const char * & InstrumentCurrentSite() {
+	static thread_local const char *site = "(none)";
+	return site;
+}
+
+inline void InstrumentReportAtExit() {
+	InstrumentReport(cerr);
+}
+
+inline void InstrumentCount(const char *container, instrumentEventT event,
+                            long bytes) {
+	instrumentRegistryT & registry = InstrumentRegistry();
+	static bool registered = (atexit(InstrumentReportAtExit), true);
+	(void) registered;
+	std::lock_guard<std::mutex> guard(registry.lock);
+	pair<const char *, const char *> key(container, InstrumentCurrentSite());
+	instrumentCountsT & counts = registry.counts[key];
+	counts.events[event]++;
+	if (event == AllocationEvent) counts.bytes += bytes;
+}
+
+inline void InstrumentReport(ostream & out) {
+#ifndef CS106_INSTRUMENT
+	out << "Instrumentation is off (compile with -DCS106_INSTRUMENT)" << endl;
+#else
+	static const char *headings[] = {
+		"allocs", "grows", "rehashes", "copies", "rotations", "iterators"
+	};
+	instrumentRegistryT & registry = InstrumentRegistry();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	char line[256];
+	snprintf(line, sizeof line, "%-10s %-16s %12s", "Container", "Site",
+	         "bytes");
+	out << line;
+	for (int i = 0; i < N_INSTRUMENT_EVENTS; i++) {
+		snprintf(line, sizeof line, " %10s", headings[i]);
+		out << line;
+	}
+	out << endl;
+	map<pair<const char *, const char *>, instrumentCountsT,
+	    instrumentKeyLessT>::iterator it;
+	for (it = registry.counts.begin(); it != registry.counts.end(); ++it) {
+		snprintf(line, sizeof line, "%-10s %-16s %12lld", it->first.first,
+		         it->first.second, it->second.bytes);
+		out << line;
+		for (int i = 0; i < N_INSTRUMENT_EVENTS; i++) {
+			snprintf(line, sizeof line, " %10ld", it->second.events[i]);
+			out << line;
+		}
+		out << endl;
+	}
+#endif
+}
+
+inline void InstrumentReset() {
+	instrumentRegistryT & registry = InstrumentRegistry();
+	std::lock_guard<std::mutex> guard(registry.lock);
+	registry.counts.clear();
+}
+
+inline InstrumentSite::InstrumentSite(const char *name) {
+	previous = InstrumentCurrentSite();
+	InstrumentCurrentSite() = name;
+}
+
+inline InstrumentSite::~InstrumentSite() {
+	InstrumentCurrentSite() = previous;
+}
+
+#endif
@@ -19,11 +19,24 @@
  * allocated so that we can change the the number of buckets (rehash)
  * when the load factor becomes too high. The map should provide O(1)
  * performance on the put/remove/get operations.
+ *
+ * The cells themselves come from a NodePool, either one owned by the
+ * map or one supplied by the client.  When the map owns its pool, the
+ * cells are freed a slab at a time when the map is cleared or deleted.
  */
 
 template <typename ValueType>
 Map<ValueType>::Map(int sizeHint) {
 	if (sizeHint < 0) Error("Negative sizeHint given to Map constructor");
+	pool = &ownPool;
+	initBuckets(sizeHint);
+	timestamp = 0L;
+}
+
+template <typename ValueType>
+Map<ValueType>::Map(int sizeHint, NodePool & sharedPool) {
+	if (sizeHint < 0) Error("Negative sizeHint given to Map constructor");
+	pool = &sharedPool;
 	initBuckets(sizeHint);
 	timestamp = 0L;
 }
@@ -60,7 +73,7 @@ void Map<ValueType>::remove(string key) {
 			buckets[hashCode] = found->next;
 		}
 		numEntries--;
-		delete found;
+		deleteCell(found);
 	}
 	timestamp++;
 }
@@ -80,9 +93,11 @@ bool Map<ValueType>::containsKey(string key) {
 
 template <typename ValueType>
 ValueType Map<ValueType>::get(string key) {
-	if (containsKey(key)) return (*this)[key];
-	Error("Attempt to get value for key which is not contained in map.");
-	return ValueType();
+	cellT *cp = findCell(buckets[hash(key)], key);
+	if (cp == NULL) {
+		Error("Attempt to get value for key which is not contained in map.");
+	}
+	return cp->value;
 }
 
 template <typename ValueType>
@@ -92,7 +107,7 @@ ValueType & Map<ValueType>::operator[](string key) {
 	if (cp == NULL) {
 		if (numEntries > buckets.size()*2) expandAndRehash();
 		hashCode = hash(key);
-		cp = new cellT;
+		cp = newCell();
 		cp->key = key;
 		cp->value = ValueType();
 		cp->next = buckets[hashCode];
@@ -115,6 +130,7 @@ const Map<ValueType> &Map<ValueType>::operator=(const Map & rhs) {
 
 template <typename ValueType>
 Map<ValueType>::Map(const Map & rhs) {
+	pool = &ownPool;
 	copyOtherEntries(rhs);
 	timestamp = 0L;
 }
@@ -161,18 +177,47 @@ void Map<ValueType>::mapAll(void (*fn)(string key, ValueType value)) {
  * Private method: deleteBuckets
  * Usage: deleteBuckets(buckets);
  * ------------------------------
- * This function deletes all the cells in the linked lists contained in vector.
+ * This function deletes all the cells in the linked lists contained in
+ * vector, which must hold every cell in the map.  If the map owns its
+ * pool, the cells are destroyed in place and their slabs are freed all
+ * at once; otherwise each cell is returned to the shared pool.
  */
 
 template <typename ValueType>
 void Map<ValueType>::deleteBuckets(Vector<cellT *> & b) {
+	bool ownsPool = (pool == &ownPool);
 	for (int i = 0; i < b.size(); i++) {
 		while (b[i] != NULL) {
 			cellT *next = b[i]->next;
-			delete b[i];
+			if (ownsPool) {
+				b[i]->~cellT();
+			} else {
+				deleteCell(b[i]);
+			}
 			b[i] = next;
 		}
 	}
+	if (ownsPool) ownPool.clear();
+}
+
+/*
+ * Private methods: newCell, deleteCell
+ * Usage: cp = newCell();
+ *        deleteCell(cp);
+ * -------------------------------------
+ * These methods construct a cell in storage taken from the pool and
+ * destroy a cell and return its storage to the pool.
+ */
+
+template <typename ValueType>
+typename Map<ValueType>::cellT *Map<ValueType>::newCell() {
+	return new (pool->allocate(sizeof(cellT))) cellT;
+}
+
+template <typename ValueType>
+void Map<ValueType>::deleteCell(cellT *cp) {
+	cp->~cellT();
+	pool->release(cp);
 }
 
 /*
@@ -223,7 +268,8 @@ int Map<ValueType>::hash(string s) {
  * Usage: expandAndRehash();
  * -------------------------
  * This method is used to increase the number of buckets in the map
- * and then rehashes all existing entries and adds them into new buckets.
+ * and then rehashes all existing entries and relinks their cells into
+ * the new buckets, so no cells are allocated or copied.
  * This operation is used when the load factor (i.e. the number of cells
  * per bucket) has increased enough to warrant this O(N) operation to
  * enlarge and redistribute the entries.
@@ -231,14 +277,21 @@ int Map<ValueType>::hash(string s) {
 
 template <typename ValueType>
 void Map<ValueType>::expandAndRehash() {
+	INSTRUMENT_EVENT("Map", RehashEvent, 0);
 	Vector<cellT *>oldBuckets = buckets;
+	int oldNumEntries = numEntries;
 	initBuckets(oldBuckets.size()*2 + 1);
 	for (int i = 0; i < oldBuckets.size(); i++) {
-		for (cellT *cp = oldBuckets[i]; cp != NULL; cp = cp->next) {
-			put(cp->key, cp->value);
+		cellT *cp = oldBuckets[i];
+		while (cp != NULL) {
+			cellT *next = cp->next;
+			int hashCode = hash(cp->key);
+			cp->next = buckets[hashCode];
+			buckets[hashCode] = cp;
+			cp = next;
 		}
 	}
-	deleteBuckets(oldBuckets);
+	numEntries = oldNumEntries;
 }
 
 /*
@@ -280,6 +333,7 @@ static void AddToMap(string key, ValueType val, Map<ValueType> & map) {
 
 template <typename ValueType>
 void Map<ValueType>::copyOtherEntries(const Map & constRhs) {
+	INSTRUMENT_EVENT("Map", CopyEvent, 0);
 	Map & rhs = const_cast<Map &>(constRhs);
 	initBuckets(rhs.size());
 	rhs.mapAll< Map<ValueType> >(AddToMap, *this);
@@ -341,7 +395,10 @@ void Map<ValueType>::Iterator::advanceToNextKey() {
 
 template <typename ValueType>
 string Map<ValueType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("Map", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
@@ -76,9 +76,13 @@ private:
 	Vector<cellT *> buckets;
 	int numEntries;
 	long timestamp;
+	NodePool ownPool;
+	NodePool *pool;
 
 	void initBuckets(int nBuckets);
 	void deleteBuckets(Vector<cellT *> & bucketsToDelete);
+	cellT *newCell();
+	void deleteCell(cellT *cp);
 	int hash(string s);
 	cellT *findCell(cellT *head, string key, cellT **prev = NULL);
 	void expandAndRehash();
@@ -0,0 +1,124 @@
+/*
+ * File: private/mappedfile.h
+ * -----------------------------------------------------
+ * This file exports the MappedFile class, which ViewScanner and
+ * MappedLexicon use to get at the contents of a file without reading
+ * it into memory they own.  It is kept in the private directory
+ * because clients have no need to see it.
+ */
+
+#ifndef _mappedfile_h
+#define _mappedfile_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include <string>
+#include <climits>
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * Class: MappedFile
+ * -----------------
+ * A MappedFile makes the contents of a file available as a read-only
+ * block of characters.  On POSIX systems the file is mapped with mmap,
+ * so opening it costs the same whatever its size and the operating
+ * system pages the contents in on demand.  An empty file cannot be
+ * mapped and is treated as an empty block.  Elsewhere the contents
+ * are read into a string, which costs one copy but looks the same to
+ * the client.
+ */
+
+class MappedFile {
+public:
+	MappedFile() {
+		chars = "";
+		length = 0;
+		mapping = NULL;
+	}
+
+	~MappedFile() {
+		close();
+	}
+
+/*
+ * Method: open
+ * Usage: if (file.open(filename)) . . .
+ * -------------------------------------
+ * Closes any file already open and maps the named file.  Returns
+ * false, leaving the block empty, if the file cannot be opened.
+ */
+	bool open(string filename) {
+		close();
+#ifdef _WIN32
+		ifstream infile(filename.c_str(), ios::in | ios::binary);
+		if (infile.fail()) return false;
+		contents.assign(istreambuf_iterator<char>(infile),
+		                istreambuf_iterator<char>());
+		chars = contents.data();
+		length = contents.length();
+#else
+		int fd = ::open(filename.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		struct stat info;
+		if (fstat(fd, &info) < 0 || info.st_size > INT_MAX) {
+			::close(fd);
+			return false;
+		}
+		if (info.st_size > 0) {
+			void *addr = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE,
+			                  fd, 0);
+			if (addr == MAP_FAILED) {
+				::close(fd);
+				return false;
+			}
+			mapping = addr;
+			chars = (const char *) addr;
+			length = info.st_size;
+		}
+		::close(fd);
+#endif
+		return true;
+	}
+
+/*
+ * Method: close
+ * Usage: file.close();
+ * --------------------
+ * Releases the contents of the file and leaves the block empty.
+ */
+	void close() {
+#ifndef _WIN32
+		if (mapping != NULL) munmap(mapping, length);
+#endif
+		mapping = NULL;
+		contents.clear();
+		chars = "";
+		length = 0;
+	}
+
+	const char *data() {
+		return chars;
+	}
+
+	int size() {
+		return length;
+	}
+
+private:
+	const char *chars;
+	int length;
+	void *mapping;
+	string contents;
+
+	DISALLOW_COPYING(MappedFile)
+};
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * File: private/mappedlexicon.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the mappedlexicon.h
+ * interface.  The methods are declared inline so that the code
+ * can live in the header, since the class is not part of the
+ * precompiled library.
+ */
+
+#ifdef _mappedlexicon_h
+
+/*
+ * MappedLexicon class implementation
+ * ----------------------------------
+ * The file begins with a text header of the form
+ *
+ *      DAWG:<start>:<bytes>:
+ *
+ * where <start> is the index of the first edge in the list of edges
+ * leaving the root and <bytes> is the size of the edge array that
+ * follows.  The edges are read directly from the mapped file, one
+ * 32-bit word at a time, so nothing is converted or copied when the
+ * file is opened.  Because the edges are never checked as a whole,
+ * every index read from the file is checked against numEdges before
+ * it is used.
+ */
+
+inline MappedLexicon::MappedLexicon() {
+	edges = NULL;
+	numEdges = startIndex = 0;
+}
+
+inline MappedLexicon::MappedLexicon(string filename) {
+	edges = NULL;
+	numEdges = startIndex = 0;
+	open(filename);
+}
+
+inline MappedLexicon::~MappedLexicon() {
+	/* Empty */
+}
+
+inline void MappedLexicon::open(string filename) {
+	edges = NULL;
+	numEdges = startIndex = 0;
+	if (!file.open(filename)) Error("Couldn't open lexicon file " + filename);
+	const char *cp = file.data();
+	const char *end = cp + file.size();
+	int fields[2];
+	bool ok = (end - cp >= 5 && strncmp(cp, "DAWG:", 5) == 0);
+	if (ok) cp += 5;
+	for (int i = 0; ok && i < 2; i++) {
+		const char *digits = cp;
+		while (cp < end && isdigit((unsigned char) *cp)) {
+			cp++;
+		}
+		ok = (cp < end && *cp == ':'
+		      && ParseInteger(digits, cp - digits, fields[i]) == ParseOK);
+		cp++;
+	}
+	if (!ok || fields[1] > end - cp) {
+		file.close();
+		Error("Improperly formed lexicon file " + filename);
+	}
+	edges = (const unsigned char *) cp;
+	numEdges = fields[1] / 4;
+	startIndex = fields[0];
+	if (startIndex >= numEdges) numEdges = 0;
+}
+
+inline bool MappedLexicon::isEmpty() {
+	return numEdges == 0;
+}
+
+inline bool MappedLexicon::containsWord(const string & word) {
+	int edge = traceToLastEdge(word.data(), word.length());
+	return edge >= 0 && (edgeAt(edge) & ACCEPT_BIT) != 0;
+}
+
+inline bool MappedLexicon::containsPrefix(const string & prefix) {
+	if (prefix.empty()) return true;
+	return traceToLastEdge(prefix.data(), prefix.length()) >= 0;
+}
+
+inline int MappedLexicon::containsWords(const string words[], int n,
+                                        bool results[]) {
+	return lookupBatch(words, n, results, false);
+}
+
+inline int MappedLexicon::containsPrefixes(const string prefixes[], int n,
+                                           bool results[]) {
+	return lookupBatch(prefixes, n, results, true);
+}
+
+/*
+ * Private method: edgeAt
+ * Usage: unsigned int edge = edgeAt(index);
+ * -----------------------------------------
+ * Returns the edge at the given index as a native integer.  The file
+ * makes no promise about alignment, so the bytes are read one at a
+ * time; compilers turn this into a single load and byte swap.
+ */
+
+inline unsigned int MappedLexicon::edgeAt(int index) {
+	const unsigned char *bp = edges + 4 * index;
+	return ((unsigned int) bp[0] << 24) | ((unsigned int) bp[1] << 16)
+	     | ((unsigned int) bp[2] << 8) | bp[3];
+}
+
+/*
+ * Private method: findEdgeForChar
+ * Usage: int edge = findEdgeForChar(children, ch);
+ * ------------------------------------------------
+ * Searches the list of sibling edges starting at index children for
+ * the edge labeled ch, returning its index or -1 if there is none.
+ * Siblings are stored in alphabetical order, which is what lets the
+ * Lexicon iterator return words in order, so the search can stop as
+ * soon as it passes the letter it is looking for.
+ */
+
+inline int MappedLexicon::findEdgeForChar(int children, char ch) {
+	if (!isalpha((unsigned char) ch)) return -1;
+	unsigned int ord = tolower((unsigned char) ch) - 'a' + 1;
+	for (int index = children; index < numEdges; index++) {
+		unsigned int edge = edgeAt(index);
+		unsigned int letter = edge & LETTER_MASK;
+		if (letter == ord) return index;
+		if (letter > ord || (edge & LAST_EDGE_BIT)) return -1;
+	}
+	return -1;
+}
+
+/*
+ * Private method: traceToLastEdge
+ * Usage: int edge = traceToLastEdge(s, length);
+ * ---------------------------------------------
+ * Follows the path spelled by the first length characters of s and
+ * returns the index of its last edge, or -1 if there is no such path.
+ * The empty string has no last edge and also returns -1.
+ */
+
+inline int MappedLexicon::traceToLastEdge(const char *s, int length) {
+	if (numEdges == 0) return -1;
+	int list = startIndex;
+	int edge = -1;
+	for (int i = 0; i < length; i++) {
+		if (i > 0 && list == 0) return -1;
+		edge = findEdgeForChar(list, s[i]);
+		if (edge < 0) return -1;
+		list = edgeAt(edge) >> CHILDREN_SHIFT;
+	}
+	return edge;
+}
+
+/*
+ * Implementation notes: lookupBatch
+ * ---------------------------------
+ * A lookup spends most of its time waiting for the next edge list to
+ * arrive from memory, since the lists of a large lexicon are scattered
+ * across the file.  lookupBatch keeps up to BATCH_WIDTH lookups in
+ * progress, each represented by a laneT.  Each pass over the lanes
+ * advances every lookup by one character and then prefetches the edge
+ * list that lookup will need next, so that by the time the pass comes
+ * back around, that list has usually arrived.  When a lookup finishes,
+ * its lane is refilled with the next query.
+ */
+
+inline int MappedLexicon::lookupBatch(const string queries[], int n,
+                                      bool results[], bool prefixes) {
+	struct laneT {
+		const char *chars;
+		int length;
+		int pos;
+		int list;
+		int edge;
+		int query;
+	};
+	if (n < 0) Error("MappedLexicon: negative query count");
+	laneT lanes[BATCH_WIDTH];
+	int nLanes = 0;
+	int nextQuery = 0;
+	int nFound = 0;
+	while (true) {
+		while (nLanes < BATCH_WIDTH && nextQuery < n) {
+			laneT & lane = lanes[nLanes++];
+			lane.chars = queries[nextQuery].data();
+			lane.length = queries[nextQuery].length();
+			lane.pos = 0;
+			lane.list = startIndex;
+			lane.edge = -1;
+			lane.query = nextQuery++;
+			prefetchEdges(lane.list);
+		}
+		if (nLanes == 0) break;
+		int i = 0;
+		while (i < nLanes) {
+			laneT & lane = lanes[i];
+			bool done = true;
+			bool result = false;
+			if (lane.pos == lane.length) {
+				result = prefixes
+				      || (lane.edge >= 0 && (edgeAt(lane.edge) & ACCEPT_BIT));
+			} else if (lane.pos == 0 || lane.list != 0) {
+				lane.edge = findEdgeForChar(lane.list, lane.chars[lane.pos]);
+				if (lane.edge >= 0) {
+					lane.pos++;
+					lane.list = edgeAt(lane.edge) >> CHILDREN_SHIFT;
+					prefetchEdges(lane.list);
+					done = false;
+				}
+			}
+			if (done) {
+				results[lane.query] = result;
+				if (result) nFound++;
+				lanes[i] = lanes[--nLanes];
+			} else {
+				i++;
+			}
+		}
+	}
+	return nFound;
+}
+
+inline void MappedLexicon::prefetchEdges(int index) {
+#if defined(__GNUC__)
+	if (index < numEdges) __builtin_prefetch(edges + 4 * index);
+#endif
+}
+
+#endif
@@ -0,0 +1,47 @@
+/*
+ * File: private/mappedlexicon.h
+ * -----------------------------------------------------
+ * This file contains the private section of the mappedlexicon.h
+ * interface.  This portion of the class definition is taken out of
+ * the mappedlexicon.h header so that the client need not have to see
+ * all of these details.
+ */
+
+/*
+ * Edge format
+ * -----------
+ * The binary lexicon file holds an array of edges, each of which is a
+ * 32-bit big-endian word.  The low five bits hold the letter (1 for
+ * 'a' through 26 for 'z'), the next bit is set on the last edge in a
+ * list of siblings, and the one after that is set if the path ending
+ * with this edge spells a word.  The high 24 bits are the index of the
+ * first child edge, or 0 if there are no children.
+ */
+	static const unsigned int LETTER_MASK = 0x1f;
+	static const unsigned int LAST_EDGE_BIT = 0x20;
+	static const unsigned int ACCEPT_BIT = 0x40;
+	static const int CHILDREN_SHIFT = 8;
+
+/*
+ * Constant: BATCH_WIDTH
+ * ---------------------
+ * The number of lookups that containsWords and containsPrefixes
+ * interleave.  This needs to be enough to cover the time it takes
+ * to fetch an edge list from memory, but not so many that the
+ * prefetched lists push each other out of the cache.
+ */
+	static const int BATCH_WIDTH = 8;
+
+	MappedFile file;
+	const unsigned char *edges;
+	int numEdges;
+	int startIndex;
+
+	unsigned int edgeAt(int index);
+	int findEdgeForChar(int children, char ch);
+	int traceToLastEdge(const char *s, int length);
+	int lookupBatch(const string queries[], int n, bool results[],
+	                bool prefixes);
+	void prefetchEdges(int index);
+
+	DISALLOW_COPYING(MappedLexicon)
@@ -0,0 +1,143 @@
+/*
+ * File: private/mpmcqueue.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the mpmcqueue.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _mpmcqueue_h
+
+/*
+ * Implementation notes: MPMCQueue class
+ * -------------------------------------
+ * This is Dmitry Vyukov's bounded queue.  Positions count up without
+ * wrapping, and position pos uses slot pos & mask.  A slot whose
+ * sequence number equals pos is empty and waiting to be filled for
+ * that position; one whose sequence number equals pos + 1 holds the
+ * element for that position and is waiting to be emptied.  Emptying a
+ * slot sets its sequence number to pos + capacity, which readies it
+ * for the enqueue that wraps around to it next.  The scheme needs at
+ * least two slots: with only one, pos + 1 is also the sequence number
+ * of an empty slot for the next position, so a full slot would look
+ * empty to producers and the queue would overwrite its element.
+ *
+ * To enqueue, a producer reads the enqueue position, checks that the
+ * slot is ready, and claims the position with a compare-and-swap.
+ * Having won the position, it owns the slot and can store the element
+ * at leisure before publishing it with a release store of the new
+ * sequence number.  If the sequence number is behind the position,
+ * the slot has not been emptied since the last time around and the
+ * queue is full.  If it is ahead, another producer got there first,
+ * and the producer starts over with a fresh position.  Dequeuing is
+ * symmetric.
+ */
+
+template <typename ElemType>
+MPMCQueue<ElemType>::MPMCQueue(int capacity) {
+	if (capacity <= 0) Error("MPMCQueue capacity must be positive");
+	unsigned long nSlots = 2;
+	while (nSlots < (unsigned long) capacity) {
+		nSlots *= 2;
+	}
+	slots = new slotT[nSlots];
+	mask = nSlots - 1;
+	for (unsigned long i = 0; i < nSlots; i++) {
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	enqueuePos.value.store(0, std::memory_order_relaxed);
+	dequeuePos.value.store(0, std::memory_order_relaxed);
+}
+
+template <typename ElemType>
+MPMCQueue<ElemType>::~MPMCQueue() {
+	delete[] slots;
+}
+
+template <typename ElemType>
+int MPMCQueue<ElemType>::capacity() {
+	return int(mask + 1);
+}
+
+template <typename ElemType>
+int MPMCQueue<ElemType>::size() {
+	unsigned long head = dequeuePos.value.load(std::memory_order_acquire);
+	unsigned long tail = enqueuePos.value.load(std::memory_order_acquire);
+	long n = long(tail - head);
+	if (n < 0) return 0;
+	if (n > long(mask + 1)) return int(mask + 1);
+	return int(n);
+}
+
+template <typename ElemType>
+bool MPMCQueue<ElemType>::isEmpty() {
+	return size() == 0;
+}
+
+template <typename ElemType>
+bool MPMCQueue<ElemType>::tryEnqueue(const ElemType & elem) {
+	unsigned long pos = enqueuePos.value.load(std::memory_order_relaxed);
+	slotT *slot;
+	while (true) {
+		slot = &slots[pos & mask];
+		unsigned long seq = slot->sequence.load(std::memory_order_acquire);
+		long diff = long(seq - pos);
+		if (diff == 0) {
+			if (enqueuePos.value.compare_exchange_weak(pos, pos + 1,
+			                                   std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = enqueuePos.value.load(std::memory_order_relaxed);
+		}
+	}
+	slot->elem = elem;
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename ElemType>
+void MPMCQueue<ElemType>::enqueue(const ElemType & elem) {
+	Backoff backoff;
+	while (!tryEnqueue(elem)) {
+		backoff.pause();
+	}
+}
+
+template <typename ElemType>
+bool MPMCQueue<ElemType>::tryDequeue(ElemType & elem) {
+	unsigned long pos = dequeuePos.value.load(std::memory_order_relaxed);
+	slotT *slot;
+	while (true) {
+		slot = &slots[pos & mask];
+		unsigned long seq = slot->sequence.load(std::memory_order_acquire);
+		long diff = long(seq - (pos + 1));
+		if (diff == 0) {
+			if (dequeuePos.value.compare_exchange_weak(pos, pos + 1,
+			                                   std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			return false;
+		} else {
+			pos = dequeuePos.value.load(std::memory_order_relaxed);
+		}
+	}
+	elem = slot->elem;
+	slot->sequence.store(pos + mask + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename ElemType>
+ElemType MPMCQueue<ElemType>::dequeue() {
+	ElemType elem;
+	Backoff backoff;
+	while (!tryDequeue(elem)) {
+		backoff.pause();
+	}
+	return elem;
+}
+
+#endif
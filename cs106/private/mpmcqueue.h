@@ -0,0 +1,43 @@
+/*
+ * File: private/mpmcqueue.h
+ * -----------------------------------------------------
+ * This file contains the private section of the mpmcqueue.h interface.
+ * This portion of the class definition is taken out of the mpmcqueue.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+/* Constant definitions */
+	static const int CACHE_LINE_SIZE = 64;
+
+/*
+ * Type: slotT
+ * -----------
+ * Each slot carries a sequence number along with the element.  The
+ * sequence number says whether the slot is ready to be filled for a
+ * given enqueue position or ready to be emptied for a given dequeue
+ * position, as described in private/mpmcqueue.cpp.
+ */
+	struct slotT {
+		std::atomic<unsigned long> sequence;
+		ElemType elem;
+	};
+
+/*
+ * Type: indexT
+ * ------------
+ * An index aligned to a cache line and filling all of it, so that
+ * producers updating the enqueue position do not slow down consumers
+ * updating the dequeue position, and vice versa.
+ */
+	struct alignas(CACHE_LINE_SIZE) indexT {
+		std::atomic<unsigned long> value;
+	};
+
+/* Instance variables */
+	slotT *slots;            /* Circular array of slots                 */
+	unsigned long mask;      /* Number of slots minus one               */
+	indexT enqueuePos;       /* Next position to fill                   */
+	indexT dequeuePos;       /* Next position to empty                  */
+
+	DISALLOW_COPYING(MPMCQueue)
@@ -0,0 +1,91 @@
+/*
+ * File: private/nodepool.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the nodepool.h interface.
+ * The methods are declared inline so that the code can live in the
+ * header alongside the collection templates that use it.
+ */
+
+#ifdef _nodepool_h
+
+/*
+ * NodePool class implementation
+ * -----------------------------
+ * The pool keeps a free list of released nodes and a "bump" range of
+ * never-used nodes at the end of the newest slab.  The allocate method
+ * takes from the free list first, then from the bump range, and only
+ * when both are empty does it call addSlab to get another slab.  The
+ * slabs double in size from FIRST_SLAB_SIZE up to nodesPerSlab, so
+ * the number of slabs grows only with the logarithm of the number of
+ * nodes until the largest size is reached.
+ */
+
+inline NodePool::NodePool(int nodesPerSlab) {
+	if (nodesPerSlab <= 0) Error("NodePool needs a positive slab size");
+	this->nodesPerSlab = nodesPerSlab;
+	nextSlabSize = (nodesPerSlab < FIRST_SLAB_SIZE) ? nodesPerSlab : FIRST_SLAB_SIZE;
+	slabs = freeList = bumpPtr = bumpEnd = NULL;
+	blocksPerNode = 0;
+}
+
+inline NodePool::~NodePool() {
+	clear();
+}
+
+inline void *NodePool::allocate(int nodeSize) {
+	int nBlocks = (nodeSize + sizeof(blockT) - 1) / sizeof(blockT);
+	if (blocksPerNode != nBlocks) {
+		if (blocksPerNode != 0) {
+			Error("NodePool shared by collections with different node sizes");
+		}
+		blocksPerNode = nBlocks;
+	}
+	if (freeList != NULL) {
+		blockT *node = freeList;
+		freeList = freeList->next;
+		return node;
+	}
+	if (bumpPtr == bumpEnd) addSlab();
+	blockT *node = bumpPtr;
+	bumpPtr += blocksPerNode;
+	return node;
+}
+
+inline void NodePool::release(void *node) {
+	blockT *bp = (blockT *) node;
+	bp->next = freeList;
+	freeList = bp;
+}
+
+inline void NodePool::clear() {
+	while (slabs != NULL) {
+		blockT *next = slabs->next;
+		delete[] slabs;
+		slabs = next;
+	}
+	freeList = bumpPtr = bumpEnd = NULL;
+	nextSlabSize = (nodesPerSlab < FIRST_SLAB_SIZE) ? nodesPerSlab : FIRST_SLAB_SIZE;
+}
+
+/*
+ * Private method: addSlab
+ * Usage: addSlab();
+ * -----------------
+ * This method allocates a new slab of nextSlabSize nodes, makes its
+ * nodes the current bump range, and doubles nextSlabSize for the next
+ * slab, up to nodesPerSlab.  The first block of the slab is reserved
+ * for the link to the previous slab.
+ */
+
+inline void NodePool::addSlab() {
+	int nBlocks = 1 + nextSlabSize * blocksPerNode;
+	INSTRUMENT_EVENT("NodePool", AllocationEvent, nBlocks * sizeof(blockT));
+	blockT *slab = new blockT[nBlocks];
+	slab->next = slabs;
+	slabs = slab;
+	bumpPtr = slab + 1;
+	bumpEnd = bumpPtr + nextSlabSize * blocksPerNode;
+	nextSlabSize = min(2 * nextSlabSize, nodesPerSlab);
+}
+
+#endif
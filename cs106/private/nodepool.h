@@ -0,0 +1,42 @@
+/*
+ * File: private/nodepool.h
+ * -----------------------------------------------------
+ * This file contains the private section of the nodepool.h interface.
+ * This portion of the class definition is taken out of the nodepool.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+/*
+ * Constant: FIRST_SLAB_SIZE
+ * -------------------------
+ * The number of nodes in the first slab of a pool.
+ */
+	static const int FIRST_SLAB_SIZE = 8;
+
+/*
+ * Type: blockT
+ * ------------
+ * The unit of allocation inside a slab.  A node occupies as many
+ * consecutive blockT values as its size requires, which keeps every
+ * node suitably aligned for the types stored in the collections.
+ * A free node reuses its first block as the link in the free list,
+ * and the first block of each slab links the slabs together.
+ */
+	union blockT {
+		blockT *next;
+		double alignDouble;
+		long alignLong;
+	};
+
+	blockT *slabs;         /* Chain of all slabs in this pool           */
+	blockT *freeList;      /* Chain of released nodes                   */
+	blockT *bumpPtr;       /* Next unused node in the newest slab       */
+	blockT *bumpEnd;       /* End of the newest slab                    */
+	int blocksPerNode;     /* Node size in blocks, 0 until first use    */
+	int nodesPerSlab;      /* Number of nodes in the largest slabs      */
+	int nextSlabSize;      /* Number of nodes in the next slab          */
+
+	void addSlab();
+
+	DISALLOW_COPYING(NodePool)
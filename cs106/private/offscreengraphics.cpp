@@ -0,0 +1,451 @@
+/*
+ * File: private/offscreengraphics.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the offscreengraphics.h
+ * interface.  The methods are declared inline so that the code
+ * can live in the header, since the class is not part of the
+ * precompiled library.
+ */
+
+#ifdef _offscreengraphics_h
+
+/*
+ * OffscreenGraphics class implementation
+ * --------------------------------------
+ * The image is an array of RGBA bytes in rows from top to bottom,
+ * which is the order both PNG and PPM files use.  Colors are kept as
+ * integers of the form 0xRRGGBB until they are stored in a pixel.
+ * Lines are drawn one pixel wide, and the lines drawn while a filled
+ * region is open are saved as the corners of a polygon, which
+ * endFilledRegion fills with a scanline fill.
+ */
+
+inline OffscreenGraphics::OffscreenGraphics(int width, int height) {
+	if (width <= 0 || height <= 0) {
+		Error("OffscreenGraphics: the width and height must be positive");
+	}
+	this->width = width;
+	this->height = height;
+	pixels = new unsigned char[4 * width * height];
+	memset(pixels, 255, 4 * width * height);
+	penX = penY = 0;
+	eraseMode = false;
+	regionOpen = false;
+	regionDensity = 1.0;
+	defineColor("Black", 0, 0, 0);
+	defineColor("Dark Gray", .35, .35, .35);
+	defineColor("Gray", .6, .6, .6);
+	defineColor("Light Gray", .75, .75, .75);
+	defineColor("White", 1, 1, 1);
+	defineColor("Red", 1, 0, 0);
+	defineColor("Yellow", 1, 1, 0);
+	defineColor("Green", 0, 1, 0);
+	defineColor("Cyan", 0, 1, 1);
+	defineColor("Blue", 0, 0, 1);
+	defineColor("Magenta", 1, 0, 1);
+	setPenColor("Black");
+}
+
+inline OffscreenGraphics::~OffscreenGraphics() {
+	delete[] pixels;
+}
+
+inline int OffscreenGraphics::getWidth() {
+	return width;
+}
+
+inline int OffscreenGraphics::getHeight() {
+	return height;
+}
+
+inline void OffscreenGraphics::movePen(double x, double y) {
+	if (regionOpen && !region.isEmpty()) {
+		Error("OffscreenGraphics: movePen is not allowed inside a region");
+	}
+	penX = x;
+	penY = y;
+}
+
+inline void OffscreenGraphics::drawLine(double dx, double dy) {
+	if (regionOpen) {
+		if (region.isEmpty()) {
+			vertexT start = { penX, penY };
+			region.add(start);
+		}
+		vertexT end = { penX + dx, penY + dy };
+		region.add(end);
+	} else {
+		plotLine(penX, penY, penX + dx, penY + dy);
+	}
+	penX += dx;
+	penY += dy;
+}
+
+/*
+ * Implementation notes: drawArc
+ * -----------------------------
+ * The center of the circle lies r pixels from the pen in the direction
+ * opposite to the start angle.  Because y grows downward on the
+ * canvas, the angles are measured with the y component negated, so
+ * that positive sweeps still turn counterclockwise on the screen.
+ */
+
+inline void OffscreenGraphics::drawArc(double r, double start, double sweep) {
+	const double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180;
+	double cx = penX - r * cos(start * RADIANS_PER_DEGREE);
+	double cy = penY + r * sin(start * RADIANS_PER_DEGREE);
+	int nSteps = max(1, int(ceil(fabs(sweep) / ARC_STEP)));
+	for (int i = 1; i <= nSteps; i++) {
+		double angle = (start + sweep * i / nSteps) * RADIANS_PER_DEGREE;
+		double x = cx + r * cos(angle);
+		double y = cy - r * sin(angle);
+		drawLine(x - penX, y - penY);
+	}
+}
+
+inline double OffscreenGraphics::getCurrentX() {
+	return penX;
+}
+
+inline double OffscreenGraphics::getCurrentY() {
+	return penY;
+}
+
+inline void OffscreenGraphics::startFilledRegion(double density) {
+	if (regionOpen) Error("OffscreenGraphics: region already in progress");
+	if (density < 0 || density > 1) {
+		Error("OffscreenGraphics: density must be between 0 and 1");
+	}
+	regionOpen = true;
+	regionDensity = density;
+	region.clear();
+}
+
+inline void OffscreenGraphics::endFilledRegion() {
+	if (!regionOpen) Error("OffscreenGraphics: no region in progress");
+	regionOpen = false;
+	fillRegion();
+	region.clear();
+}
+
+inline void OffscreenGraphics::fillBox(double x, double y, double width,
+                                       double height) {
+	int startRow = max(0, int(ceil(y - 0.5)));
+	int endRow = min(this->height, int(ceil(y + height - 0.5)));
+	int startCol = int(ceil(x - 0.5));
+	int endCol = int(ceil(x + width - 0.5));
+	int color = drawingColor();
+	for (int row = startRow; row < endRow; row++) {
+		fillSpan(row, startCol, endCol, color, 1.0);
+	}
+}
+
+inline void OffscreenGraphics::setPenColor(string color) {
+	string key = ConvertToLowerCase(color);
+	if (!colors.containsKey(key)) Error("Undefined color: " + color);
+	penColor = colors.get(key);
+	penColorName = color;
+}
+
+inline void OffscreenGraphics::setPenColorRGB(double red, double green,
+                                              double blue) {
+	penColor = rgbToColor(red, green, blue);
+	penColorName = "";
+}
+
+inline void OffscreenGraphics::defineColor(string name, double red,
+                                           double green, double blue) {
+	colors.put(ConvertToLowerCase(name), rgbToColor(red, green, blue));
+}
+
+inline string OffscreenGraphics::getPenColor() {
+	return penColorName;
+}
+
+inline void OffscreenGraphics::setEraseMode(bool mode) {
+	eraseMode = mode;
+}
+
+inline bool OffscreenGraphics::getEraseMode() {
+	return eraseMode;
+}
+
+inline int OffscreenGraphics::getPixel(int x, int y) {
+	if (x < 0 || x >= width || y < 0 || y >= height) {
+		Error("OffscreenGraphics: pixel is outside the canvas");
+	}
+	unsigned char *pp = pixels + 4 * (y * width + x);
+	return (pp[0] << 16) | (pp[1] << 8) | pp[2];
+}
+
+inline const unsigned char *OffscreenGraphics::getPixels() {
+	return pixels;
+}
+
+inline void OffscreenGraphics::writePPM(string filename) {
+	ofstream out(filename.c_str(), ios::binary);
+	if (out.fail()) Error("Can't open " + filename);
+	out << "P6\n" << width << " " << height << "\n255\n";
+	string row(3 * width, '\0');
+	for (int y = 0; y < height; y++) {
+		unsigned char *pp = pixels + 4 * y * width;
+		for (int x = 0; x < width; x++) {
+			row[3 * x] = pp[4 * x];
+			row[3 * x + 1] = pp[4 * x + 1];
+			row[3 * x + 2] = pp[4 * x + 2];
+		}
+		out.write(row.data(), row.length());
+	}
+	if (out.fail()) Error("Can't write " + filename);
+}
+
+/*
+ * Implementation notes: writePNG
+ * ------------------------------
+ * A PNG file is a signature followed by chunks: IHDR describes the
+ * image, IDAT holds the pixels, and IEND marks the end.  The pixel data
+ * is each row preceded by a zero byte, which selects no filtering,
+ * wrapped in a zlib stream.  The stream uses deflate's stored blocks,
+ * which hold up to 65535 bytes each without compression, so the only
+ * computation needed is the Adler-32 checksum at the end of the stream
+ * and the CRC-32 that ends each chunk.
+ */
+
+inline void OffscreenGraphics::writePNG(string filename) {
+	const int MAX_STORED_BLOCK = 65535;
+	ofstream out(filename.c_str(), ios::binary);
+	if (out.fail()) Error("Can't open " + filename);
+	out.write("\x89PNG\r\n\x1a\n", 8);
+	string header;
+	putBigEndian32(header, width);
+	putBigEndian32(header, height);
+	header += string("\x08\x06\x00\x00\x00", 5);
+	writePNGChunk(out, "IHDR", header);
+	string raw;
+	raw.reserve((4 * width + 1) * height);
+	for (int y = 0; y < height; y++) {
+		raw += '\0';
+		raw.append((const char *) pixels + 4 * y * width, 4 * width);
+	}
+	unsigned int a = 1, b = 0;
+	for (int i = 0; i < (int) raw.length(); i++) {
+		a = (a + (unsigned char) raw[i]) % 65521;
+		b = (b + a) % 65521;
+	}
+	string data("\x78\x01", 2);
+	data.reserve(raw.length() + 5 * (raw.length() / MAX_STORED_BLOCK + 1) + 6);
+	int pos = 0;
+	do {
+		int n = min(MAX_STORED_BLOCK, (int) raw.length() - pos);
+		data += (pos + n == (int) raw.length()) ? '\x01' : '\x00';
+		data += char(n & 0xff);
+		data += char(n >> 8);
+		data += char(~n & 0xff);
+		data += char((~n >> 8) & 0xff);
+		data.append(raw, pos, n);
+		pos += n;
+	} while (pos < (int) raw.length());
+	putBigEndian32(data, (b << 16) | a);
+	writePNGChunk(out, "IDAT", data);
+	writePNGChunk(out, "IEND", "");
+	if (out.fail()) Error("Can't write " + filename);
+}
+
+/*
+ * Private method: plotPixel
+ * Usage: plotPixel(x, y, color);
+ * ------------------------------
+ * Sets one pixel to the given color, ignoring pixels off the canvas.
+ */
+
+inline void OffscreenGraphics::plotPixel(int x, int y, int color) {
+	if (x < 0 || x >= width || y < 0 || y >= height) return;
+	unsigned char *pp = pixels + 4 * (y * width + x);
+	pp[0] = (unsigned char) (color >> 16);
+	pp[1] = (unsigned char) (color >> 8);
+	pp[2] = (unsigned char) color;
+}
+
+/*
+ * Private method: plotLine
+ * Usage: plotLine(x0, y0, x1, y1);
+ * --------------------------------
+ * Draws a line one pixel wide by stepping one pixel at a time along
+ * its longer direction and setting the pixel that contains each point.
+ */
+
+inline void OffscreenGraphics::plotLine(double x0, double y0, double x1,
+                                        double y1) {
+	int color = drawingColor();
+	double dx = x1 - x0;
+	double dy = y1 - y0;
+	int nSteps = int(ceil(max(fabs(dx), fabs(dy))));
+	if (nSteps == 0) {
+		plotPixel(int(floor(x0)), int(floor(y0)), color);
+		return;
+	}
+	for (int i = 0; i <= nSteps; i++) {
+		plotPixel(int(floor(x0 + dx * i / nSteps)),
+		          int(floor(y0 + dy * i / nSteps)), color);
+	}
+}
+
+/*
+ * Private method: fillSpan
+ * Usage: fillSpan(row, startCol, endCol, color, density);
+ * -------------------------------------------------------
+ * Fills the pixels of a row from startCol up to but not including
+ * endCol, clipped to the canvas.  A density below 1 fills only the
+ * pixels whose entry in a 4 x 4 ordered-dither matrix is below
+ * 16 * density, which spreads the filled pixels evenly.
+ */
+
+inline void OffscreenGraphics::fillSpan(int row, int startCol, int endCol,
+                                        int color, double density) {
+	static const int DITHER[4][4] = {
+		{ 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 }
+	};
+	startCol = max(0, startCol);
+	endCol = min(width, endCol);
+	unsigned char r = (unsigned char) (color >> 16);
+	unsigned char g = (unsigned char) (color >> 8);
+	unsigned char b = (unsigned char) color;
+	unsigned char *pp = pixels + 4 * (row * width + startCol);
+	for (int col = startCol; col < endCol; col++, pp += 4) {
+		if (density < 1 && DITHER[row & 3][col & 3] >= 16 * density) continue;
+		pp[0] = r;
+		pp[1] = g;
+		pp[2] = b;
+	}
+}
+
+/*
+ * Implementation notes: fillRegion
+ * --------------------------------
+ * The region is filled one row at a time, sampling each row at the
+ * centers of its pixels.  The sides of the polygon are sorted by the
+ * first row they reach, and the scan keeps a list of the sides that
+ * cross the current row.  The points where those sides cross the row
+ * are sorted, and the pixels between the first and second crossing,
+ * the third and fourth, and so on are inside the polygon.  This is the
+ * even-odd rule, which gives the usual result for the simple shapes
+ * the library draws.  The polygon is closed by a side from the last
+ * corner back to the first if the lines did not end where they began.
+ */
+
+inline void OffscreenGraphics::fillRegion() {
+	int n = region.size();
+	if (n < 3 || regionDensity == 0) return;
+	edges.clear();
+	for (int i = 0; i < n; i++) {
+		vertexT & v0 = region[i];
+		vertexT & v1 = region[(i + 1) % n];
+		if (v0.y == v1.y) continue;
+		edgeT edge;
+		bool down = v0.y < v1.y;
+		vertexT & top = down ? v0 : v1;
+		vertexT & bottom = down ? v1 : v0;
+		edge.yTop = top.y;
+		edge.yBottom = bottom.y;
+		edge.x = top.x;
+		edge.slope = (bottom.x - top.x) / (bottom.y - top.y);
+		edges.add(edge);
+	}
+	if (edges.isEmpty()) return;
+	sort(&edges[0], &edges[0] + edges.size());
+	double yMax = edges[0].yBottom;
+	for (int i = 1; i < edges.size(); i++) {
+		yMax = max(yMax, edges[i].yBottom);
+	}
+	int startRow = max(0, int(ceil(edges[0].yTop - 0.5)));
+	int endRow = min(height, int(ceil(yMax - 0.5)));
+	int color = drawingColor();
+	int nextEdge = 0;
+	Vector<int> active;
+	for (int row = startRow; row < endRow; row++) {
+		double yc = row + 0.5;
+		while (nextEdge < edges.size() && edges[nextEdge].yTop <= yc) {
+			active.add(nextEdge++);
+		}
+		crossings.clear();
+		for (int i = 0; i < active.size(); i++) {
+			edgeT & edge = edges[active[i]];
+			if (edge.yBottom <= yc) {
+				active.removeAt(i--);
+			} else if (edge.yTop <= yc) {
+				crossings.add(edge.x + (yc - edge.yTop) * edge.slope);
+			}
+		}
+		if (crossings.size() < 2) continue;
+		sort(&crossings[0], &crossings[0] + crossings.size());
+		for (int i = 0; i + 1 < crossings.size(); i += 2) {
+			fillSpan(row, int(ceil(crossings[i] - 0.5)),
+			         int(ceil(crossings[i + 1] - 0.5)), color, regionDensity);
+		}
+	}
+}
+
+inline int OffscreenGraphics::drawingColor() {
+	return eraseMode ? 0xffffff : penColor;
+}
+
+inline int OffscreenGraphics::rgbToColor(double red, double green,
+                                         double blue) {
+	if (red < 0 || red > 1 || green < 0 || green > 1 || blue < 0 || blue > 1) {
+		Error("Color values must be between 0 and 1");
+	}
+	return (int(red * 255 + 0.5) << 16) | (int(green * 255 + 0.5) << 8)
+	     | int(blue * 255 + 0.5);
+}
+
+inline void OffscreenGraphics::putBigEndian32(string & out,
+                                              unsigned int value) {
+	out += char(value >> 24);
+	out += char((value >> 16) & 0xff);
+	out += char((value >> 8) & 0xff);
+	out += char(value & 0xff);
+}
+
+/*
+ * Private method: crc32
+ * Usage: unsigned int crc = crc32(data, start);
+ * ---------------------------------------------
+ * Returns the CRC-32 of the characters of data from index start to
+ * the end, using the table-driven method.  The table is built the
+ * first time it is needed; C++11 guarantees that this happens only
+ * once even if several threads write files at the same time.
+ */
+
+inline unsigned int OffscreenGraphics::crc32(const string & data,
+                                             int start) {
+	struct crcTableT {
+		unsigned int entries[256];
+		crcTableT() {
+			for (unsigned int n = 0; n < 256; n++) {
+				unsigned int c = n;
+				for (int k = 0; k < 8; k++) {
+					c = (c & 1) ? 0xedb88320U ^ (c >> 1) : c >> 1;
+				}
+				entries[n] = c;
+			}
+		}
+	};
+	static const crcTableT table;
+	unsigned int crc = 0xffffffffU;
+	for (int i = start; i < (int) data.length(); i++) {
+		crc = table.entries[(crc ^ (unsigned char) data[i]) & 0xff] ^ (crc >> 8);
+	}
+	return crc ^ 0xffffffffU;
+}
+
+inline void OffscreenGraphics::writePNGChunk(ofstream & out, string type,
+                                             const string & data) {
+	string chunk;
+	putBigEndian32(chunk, data.length());
+	chunk += type;
+	chunk += data;
+	putBigEndian32(chunk, crc32(chunk, 4));
+	out.write(chunk.data(), chunk.length());
+}
+
+#endif
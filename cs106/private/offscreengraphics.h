@@ -0,0 +1,66 @@
+/*
+ * File: private/offscreengraphics.h
+ * -----------------------------------------------------
+ * This file contains the private section of the offscreengraphics.h
+ * interface.  This portion of the class definition is taken out of
+ * the offscreengraphics.h header so that the client need not have to
+ * see all of these details.
+ */
+
+/*
+ * Type: vertexT
+ * -------------
+ * A corner of the region being filled, in canvas coordinates.
+ */
+	struct vertexT {
+		double x, y;
+	};
+
+/*
+ * Type: edgeT
+ * -----------
+ * A non-horizontal side of the region being filled, as used by the
+ * scanline fill.  The edge covers the rows whose centers lie in
+ * [yTop, yBottom), x is its position at yTop, and slope is the change
+ * in x for each unit of y.
+ */
+	struct edgeT {
+		double yTop, yBottom;
+		double x, slope;
+		bool operator<(const edgeT & other) const {
+			return yTop < other.yTop;
+		}
+	};
+
+/*
+ * Constant: ARC_STEP
+ * ------------------
+ * The number of degrees covered by each of the short lines that make
+ * up an arc.
+ */
+	static const int ARC_STEP = 5;
+
+	int width, height;
+	unsigned char *pixels;
+	double penX, penY;
+	int penColor;
+	string penColorName;
+	bool eraseMode;
+	bool regionOpen;
+	double regionDensity;
+	Vector<vertexT> region;
+	Vector<edgeT> edges;
+	Vector<double> crossings;
+	Map<int> colors;
+
+	void plotPixel(int x, int y, int color);
+	void plotLine(double x0, double y0, double x1, double y1);
+	void fillSpan(int row, int startCol, int endCol, int color, double density);
+	void fillRegion();
+	int drawingColor();
+	static int rgbToColor(double red, double green, double blue);
+	static void putBigEndian32(string & out, unsigned int value);
+	static unsigned int crc32(const string & data, int start);
+	static void writePNGChunk(ofstream & out, string type, const string & data);
+
+	DISALLOW_COPYING(OffscreenGraphics)
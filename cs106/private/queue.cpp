@@ -12,20 +12,26 @@
 /*
  * Queue class implementation
  * --------------------------
- * The Queue is internally managed as a singly linked list of cells, with a
- * head and tail pointer.  The front of the queue is at the head; the end
- * is at the tail.
+ * The Queue is internally managed as a circular array.  The front of
+ * the queue is at index head, and the remaining elements follow it,
+ * wrapping around from the end of the array to the beginning.  The
+ * capacity is always a power of two so that wrapping an index is a
+ * single mask operation.  When the array fills up, ensureCapacity
+ * doubles it and unwraps the elements so that the front is at index 0.
+ * A slot that no longer holds an element is reset to ElemType(), so
+ * that the queue does not keep the memory of strings or other large
+ * values it has already given back.
  */
 
 template <typename ElemType>
 Queue<ElemType>::Queue() {
-	head = tail = NULL;
-	count = 0;
+	elements = NULL;
+	capacity = head = count = 0;
 }
 
 template <typename ElemType>
 Queue<ElemType>::~Queue() {
-	deleteCells();
+	delete[] elements;
 }
 
 template <typename ElemType>
@@ -40,25 +46,17 @@ bool Queue<ElemType>::isEmpty() {
 
 template <typename ElemType>
 void Queue<ElemType>::enqueue(ElemType elem) {
-	cellT *newOne = new cellT;
-	newOne->elem = elem;
-	newOne->next = NULL;
-	if (head != NULL) {
-		tail->next = newOne;
-	} else {
-		head = newOne;
-	}
-	tail = newOne;
+	if (count == capacity) ensureCapacity(count + 1);
+	elements[(head + count) & (capacity - 1)] = elem;
 	count++;
 }
 
 template <typename ElemType>
 ElemType Queue<ElemType>::dequeue() {
 	if (isEmpty()) Error("Attempt to dequeue from empty queue");
-	ElemType first = head->elem;
-	cellT *toDelete = head;
-	head = head->next;
-	delete toDelete;
+	ElemType first = elements[head];
+	elements[head] = ElemType();
+	head = (head + 1) & (capacity - 1);
 	count--;
 	return first;
 }
@@ -66,23 +64,89 @@ ElemType Queue<ElemType>::dequeue() {
 template <typename ElemType>
 ElemType Queue<ElemType>::peek() {
 	if (isEmpty()) Error("Attempt to peek at empty queue");
-	return head->elem;
+	return elements[head];
 }
 
 template <typename ElemType>
 void Queue<ElemType>::clear() {
-	deleteCells();
-	count = 0;
+	for (int i = 0; i < count; i++) {
+		elements[(head + i) & (capacity - 1)] = ElemType();
+	}
+	head = count = 0;
+}
+
+/*
+ * Implementation notes: enqueueAll, dequeueAll
+ * --------------------------------------------
+ * The occupied part of the array and the free part each consist of at
+ * most two contiguous runs, one ending at the end of the array and one
+ * starting at index 0.  These methods copy the first run and then, if
+ * there are elements left over, the second.
+ */
+
+template <typename ElemType>
+void Queue<ElemType>::enqueueAll(const ElemType array[], int n) {
+	if (n < 0) Error("enqueueAll: negative element count");
+	if (n == 0) return;
+	ensureCapacity(count + n);
+	int tail = (head + count) & (capacity - 1);
+	int firstRun = capacity - tail;
+	if (firstRun > n) firstRun = n;
+	for (int i = 0; i < firstRun; i++) {
+		elements[tail + i] = array[i];
+	}
+	for (int i = firstRun; i < n; i++) {
+		elements[i - firstRun] = array[i];
+	}
+	count += n;
 }
 
 template <typename ElemType>
-void Queue<ElemType>::deleteCells() {
-	while (head != NULL) {
-		cellT *next = head->next;
-		delete head;
-		head = next;
+int Queue<ElemType>::dequeueAll(ElemType array[], int maxElems) {
+	if (maxElems < 0) Error("dequeueAll: negative element count");
+	int n = (maxElems < count) ? maxElems : count;
+	if (n == 0) return 0;
+	int firstRun = capacity - head;
+	if (firstRun > n) firstRun = n;
+	for (int i = 0; i < firstRun; i++) {
+		array[i] = elements[head + i];
+		elements[head + i] = ElemType();
+	}
+	for (int i = firstRun; i < n; i++) {
+		array[i] = elements[i - firstRun];
+		elements[i - firstRun] = ElemType();
+	}
+	head = (head + n) & (capacity - 1);
+	count -= n;
+	return n;
+}
+
+/*
+ * Private method: ensureCapacity
+ * Usage: ensureCapacity(n);
+ * -------------------------
+ * Makes sure the array has room for at least n elements, doubling its
+ * size as needed.  The elements are copied into the new array in
+ * queue order, starting at index 0.
+ */
+
+template <typename ElemType>
+void Queue<ElemType>::ensureCapacity(int n) {
+	if (n <= capacity) return;
+	int newCapacity = (capacity == 0) ? 16 : capacity;
+	while (newCapacity < n) {
+		newCapacity *= 2;
+	}
+	INSTRUMENT_EVENT("Queue", GrowEvent, 0);
+	INSTRUMENT_EVENT("Queue", AllocationEvent, newCapacity * sizeof(ElemType));
+	ElemType *newArray = new ElemType[newCapacity];
+	for (int i = 0; i < count; i++) {
+		newArray[i] = elements[(head + i) & (capacity - 1)];
 	}
-	tail = NULL;
+	delete[] elements;
+	elements = newArray;
+	capacity = newCapacity;
+	head = 0;
 }
 
 template <typename ElemType>
@@ -96,15 +160,19 @@ const Queue<ElemType> &Queue<ElemType>::operator=(const Queue & rhs) {
 
 template <typename ElemType>
 Queue<ElemType>::Queue(const Queue & rhs) {
-	head = tail = NULL;
-	count = 0;
+	elements = NULL;
+	capacity = head = count = 0;
 	copyOtherData(rhs);
 }
 
 template <typename ElemType>
 void Queue<ElemType>::copyOtherData(const Queue & rhs) {
-	for (cellT *cur = rhs.head; cur != NULL; cur = cur->next) {
-		enqueue(cur->elem);
+	INSTRUMENT_EVENT("Queue", CopyEvent, 0);
+	ensureCapacity(rhs.count);
+	for (int i = 0; i < rhs.count; i++) {
+		elements[i] = rhs.elements[(rhs.head + i) & (rhs.capacity - 1)];
 	}
+	head = 0;
+	count = rhs.count;
 }
 #endif
@@ -27,13 +27,10 @@ public:
 	Queue(const Queue & rhs);
 
 private:
-	struct cellT {
-		ElemType elem;
-		cellT *next;
-	};
+	ElemType *elements;    /* Circular array holding the elements     */
+	int capacity;          /* Size of the array, 0 or a power of two  */
+	int head;              /* Index of the front element              */
+	int count;             /* Number of elements in the queue         */
 
-	cellT *head;
-	cellT *tail;
-	int count;
-	void deleteCells();
+	void ensureCapacity(int n);
 	void copyOtherData(const Queue & rhs);
@@ -0,0 +1,172 @@
+/*
+ * File: private/random.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the RandomGenerator class
+ * in the random.h interface.  The free functions in random.h are in
+ * the precompiled library; the methods here are declared inline so
+ * that the code can live in the header.
+ */
+
+#ifdef _random_h
+
+#include <ctime>
+#include <chrono>
+
+/*
+ * RandomGenerator class implementation
+ * ------------------------------------
+ * The generator is xoshiro256** by David Blackman and Sebastiano Vigna,
+ * whose state is four 64-bit words.  Seeds are spread over the state
+ * with the SplitMix64 generator, as the authors recommend, which also
+ * guarantees that the state is never all zero.  Each method copies the
+ * state into a local array, works on the copy, and stores it back, so
+ * that the compiler can keep the state in registers.
+ */
+
+inline RandomGenerator::RandomGenerator() {
+	setSeed(0);
+}
+
+inline RandomGenerator::RandomGenerator(uint64_t seed) {
+	setSeed(seed);
+}
+
+inline void RandomGenerator::setSeed(uint64_t seed) {
+	for (int i = 0; i < 4; i++) {
+		state[i] = splitMix(seed);
+	}
+}
+
+inline void RandomGenerator::randomize() {
+	uint64_t seed = std::chrono::high_resolution_clock::now()
+	                .time_since_epoch().count();
+	setSeed(seed ^ ((uint64_t) time(NULL) << 32) ^ (uintptr_t) this);
+}
+
+inline uint64_t RandomGenerator::nextBits() {
+	return step(state);
+}
+
+inline int RandomGenerator::nextInteger(int low, int high) {
+	if (low > high) Error("nextInteger: low is greater than high");
+	return integerFrom(state, low, high);
+}
+
+inline double RandomGenerator::nextReal(double low, double high) {
+	return realFrom(state, low, high);
+}
+
+inline bool RandomGenerator::nextChance(double p) {
+	return nextReal(0, 1) < p;
+}
+
+inline void RandomGenerator::fillIntegers(int array[], int n,
+                                          int low, int high) {
+	if (low > high) Error("fillIntegers: low is greater than high");
+	uint64_t st[4] = { state[0], state[1], state[2], state[3] };
+	for (int i = 0; i < n; i++) {
+		array[i] = integerFrom(st, low, high);
+	}
+	for (int i = 0; i < 4; i++) {
+		state[i] = st[i];
+	}
+}
+
+inline void RandomGenerator::fillReals(double array[], int n,
+                                       double low, double high) {
+	uint64_t st[4] = { state[0], state[1], state[2], state[3] };
+	for (int i = 0; i < n; i++) {
+		array[i] = realFrom(st, low, high);
+	}
+	for (int i = 0; i < 4; i++) {
+		state[i] = st[i];
+	}
+}
+
+/*
+ * Implementation notes: jump
+ * --------------------------
+ * Jumping ahead is a multiplication in the polynomial ring that
+ * defines the generator's linear recurrence.  The constants are the
+ * polynomial for 2^128 steps, published with the algorithm.
+ */
+
+inline void RandomGenerator::jump() {
+	static const uint64_t JUMP[] = {
+		0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+		0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+	};
+	uint64_t st[4] = { state[0], state[1], state[2], state[3] };
+	uint64_t acc[4] = { 0, 0, 0, 0 };
+	for (int i = 0; i < 4; i++) {
+		for (int b = 0; b < 64; b++) {
+			if (JUMP[i] & ((uint64_t) 1 << b)) {
+				for (int j = 0; j < 4; j++) {
+					acc[j] ^= st[j];
+				}
+			}
+			step(st);
+		}
+	}
+	for (int i = 0; i < 4; i++) {
+		state[i] = acc[i];
+	}
+}
+
+inline uint64_t RandomGenerator::rotl(uint64_t x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+inline uint64_t RandomGenerator::splitMix(uint64_t & x) {
+	uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+}
+
+inline uint64_t RandomGenerator::step(uint64_t st[4]) {
+	uint64_t result = rotl(st[1] * 5, 7) * 9;
+	uint64_t t = st[1] << 17;
+	st[2] ^= st[0];
+	st[3] ^= st[1];
+	st[1] ^= st[2];
+	st[0] ^= st[3];
+	st[2] ^= t;
+	st[3] = rotl(st[3], 45);
+	return result;
+}
+
+/*
+ * Implementation notes: integerFrom
+ * ---------------------------------
+ * A random integer below range is the high half of the product of a
+ * random 32-bit value and range.  Some products are rejected so that
+ * every result is equally likely; the test against range itself is
+ * almost always enough to rule that out without the slow division.
+ * The method is by Daniel Lemire.
+ */
+
+inline int RandomGenerator::integerFrom(uint64_t st[4], int low, int high) {
+	uint64_t range = (uint64_t) ((int64_t) high - low) + 1;
+	uint32_t x = (uint32_t) (step(st) >> 32);
+	if (range > 0xffffffffULL) return (int) x;
+	uint64_t m = (uint64_t) x * range;
+	uint32_t l = (uint32_t) m;
+	if (l < range) {
+		uint32_t threshold = (uint32_t) -(uint32_t) range % (uint32_t) range;
+		while (l < threshold) {
+			x = (uint32_t) (step(st) >> 32);
+			m = (uint64_t) x * range;
+			l = (uint32_t) m;
+		}
+	}
+	return (int) ((int64_t) low + (int64_t) (m >> 32));
+}
+
+inline double RandomGenerator::realFrom(uint64_t st[4],
+                                        double low, double high) {
+	double unit = (step(st) >> 11) * (1.0 / 9007199254740992.0);
+	return low + unit * (high - low);
+}
+
+#endif
@@ -0,0 +1,16 @@
+/*
+ * File: private/random.h
+ * -----------------------------------------------------
+ * This file contains the private section of the RandomGenerator
+ * class in the random.h interface.  This portion of the class
+ * definition is taken out of the random.h header so that the client
+ * need not have to see all of these details.
+ */
+
+	uint64_t state[4];
+
+	static uint64_t rotl(uint64_t x, int k);
+	static uint64_t splitMix(uint64_t & x);
+	static uint64_t step(uint64_t st[4]);
+	static int integerFrom(uint64_t st[4], int low, int high);
+	static double realFrom(uint64_t st[4], double low, double high);
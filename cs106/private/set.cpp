@@ -9,48 +9,48 @@
 
 #ifdef _set_h
 
-template <typename ElemType>
-Set<ElemType>::Set(int (*cmp)(ElemType, ElemType)) : bst(cmp) {
-	cmpFn = cmp;
+template <typename ElemType, typename Comparator>
+Set<ElemType, Comparator>::Set(Comparator cmp) : bst(cmp), cmpFn(cmp) {
+	/* Empty */
 }
 
-template <typename ElemType>
-Set<ElemType>::~Set() {
+template <typename ElemType, typename Comparator>
+Set<ElemType, Comparator>::~Set() {
 	/* Empty */
 }
 
-template <typename ElemType>
-int Set<ElemType>::size() {
+template <typename ElemType, typename Comparator>
+int Set<ElemType, Comparator>::size() {
 	return bst.size();
 }
 
-template <typename ElemType>
-bool Set<ElemType>::isEmpty() {
+template <typename ElemType, typename Comparator>
+bool Set<ElemType, Comparator>::isEmpty() {
 	return bst.isEmpty();
 }
 
-template <typename ElemType>
-void Set<ElemType>::add(ElemType element) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::add(const ElemType & element) {
 	bst.add(element);
 }
 
-template <typename ElemType>
-void Set<ElemType>::remove(ElemType element) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::remove(const ElemType & element) {
 	bst.remove(element);
 }
 
-template <typename ElemType>
-bool Set<ElemType>::contains(ElemType element) {
+template <typename ElemType, typename Comparator>
+bool Set<ElemType, Comparator>::contains(const ElemType & element) {
 	return find(element) != NULL;
 }
 
-template <typename ElemType>
-ElemType *Set<ElemType>::find(ElemType element) {
+template <typename ElemType, typename Comparator>
+ElemType *Set<ElemType, Comparator>::find(const ElemType & element) {
 	return bst.find(element);
 }
 
-template <typename ElemType>
-void Set<ElemType>::clear() {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::clear() {
 	bst.clear();
 }
 
@@ -62,8 +62,8 @@ void Set<ElemType>::clear() {
  * one (or both) sets, doing add/remove/comparision.
  */
 
-template <typename ElemType>
-bool Set<ElemType>::equals(Set & otherSet) {
+template <typename ElemType, typename Comparator>
+bool Set<ElemType, Comparator>::equals(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("Equals: sets have different comparison functions");
 	}
@@ -74,8 +74,8 @@ bool Set<ElemType>::equals(Set & otherSet) {
 	return !thisItr.hasNext() && !otherItr.hasNext();
 }
 
-template <typename ElemType>
-bool Set<ElemType>::isSubsetOf(Set & otherSet) {
+template <typename ElemType, typename Comparator>
+bool Set<ElemType, Comparator>::isSubsetOf(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("isSubsetOf: sets have different comparison functions");
 	}
@@ -86,8 +86,8 @@ bool Set<ElemType>::isSubsetOf(Set & otherSet) {
 	return true;
 }
 
-template <typename ElemType>
-void Set<ElemType>::unionWith(Set & otherSet) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::unionWith(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("unionWith: sets have different comparison functions");
 	}
@@ -107,8 +107,8 @@ void Set<ElemType>::unionWith(Set & otherSet) {
  * to be deleted in a vector and then deletes those.
  */
 
-template <typename ElemType>
-void Set<ElemType>::intersectWith(Set & otherSet) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::intersectWith(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("intersectWith:"
 		      " sets have different comparison functions");
@@ -124,16 +124,16 @@ void Set<ElemType>::intersectWith(Set & otherSet) {
 	}
 }
 
-template <typename ElemType>
-void Set<ElemType>::intersect(Set & otherSet) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::intersect(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("intersect: sets have different comparison functions");
 	}
 	intersectWith(otherSet);
 }
 
-template <typename ElemType>
-void Set<ElemType>::subtract(Set & otherSet) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::subtract(Set & otherSet) {
 	if (cmpFn != otherSet.cmpFn) {
 		Error("subtract: sets have different comparison functions");
 	}
@@ -143,15 +143,15 @@ void Set<ElemType>::subtract(Set & otherSet) {
 	}
 }
 
-template <typename ElemType>
-void Set<ElemType>::mapAll(void (*fn)(ElemType)) {
+template <typename ElemType, typename Comparator>
+void Set<ElemType, Comparator>::mapAll(void (*fn)(ElemType)) {
 	bst.mapAll(fn);
 }
 
-template <typename ElemType>
+template <typename ElemType, typename Comparator>
 template <typename ClientDataType>
-void Set<ElemType>::mapAll(void (*fn)(ElemType, ClientDataType &),
-                           ClientDataType & data) {
+void Set<ElemType, Comparator>::mapAll(void (*fn)(ElemType, ClientDataType &),
+                                       ClientDataType & data) {
 	bst.mapAll(fn, data);
 }
 
@@ -162,34 +162,38 @@ void Set<ElemType>::mapAll(void (*fn)(ElemType, ClientDataType &),
  * Iterator for the BST class.
  */
 
-template <typename ElemType>
-Set<ElemType>::Iterator::Iterator() {
+template <typename ElemType, typename Comparator>
+Set<ElemType, Comparator>::Iterator::Iterator() {
 	/* Empty */
 }
 
-template <typename ElemType>
-typename Set<ElemType>::Iterator Set<ElemType>::iterator() {
+template <typename ElemType, typename Comparator>
+typename Set<ElemType, Comparator>::Iterator
+         Set<ElemType, Comparator>::iterator() {
 	return Iterator(this);
 }
 
-template <typename ElemType>
-Set<ElemType>::Iterator::Iterator(Set *setptr) {
+template <typename ElemType, typename Comparator>
+Set<ElemType, Comparator>::Iterator::Iterator(Set *setptr) {
 	iterator = setptr->bst.iterator();
 }
 
-template <typename ElemType>
-bool Set<ElemType>::Iterator::hasNext() {
+template <typename ElemType, typename Comparator>
+bool Set<ElemType, Comparator>::Iterator::hasNext() {
 	return iterator.hasNext();
 }
 
-template <typename ElemType>
-ElemType Set<ElemType>::Iterator::next() {
+template <typename ElemType, typename Comparator>
+ElemType Set<ElemType, Comparator>::Iterator::next() {
 	return iterator.next();
 }
 
-template <typename ElemType>
-ElemType Set<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+template <typename ElemType, typename Comparator>
+ElemType Set<ElemType, Comparator>::foreachHook(FE_State & fe) {
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("Set", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
@@ -18,8 +18,8 @@ public:
 	void intersect(Set & otherSet);
 
 /*
- * Class: Set<ElemType>::Iterator
- * ---------------------------------
+ * Class: Set<ElemType, Comparator>::Iterator
+ * -------------------------------------------
  * This interface defines a nested class within the Set template that
  * provides iterator access to the Set contents.
  */
@@ -31,7 +31,7 @@ public:
 
 	private:
 		Iterator(Set *setptr);
-		typename BST<ElemType>::Iterator iterator;
+		typename BST<ElemType, Comparator>::Iterator iterator;
 		friend class Set;
 	};
 	friend class Iterator;
@@ -53,5 +53,5 @@ public:
  */
 
 private:
-	BST<ElemType> bst;
-	int (*cmpFn)(ElemType, ElemType);
+	BST<ElemType, Comparator> bst;
+	Comparator cmpFn;
@@ -0,0 +1,106 @@
+/*
+ * File: private/spscqueue.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the spscqueue.h interface.
+ * Because of the way C++ compiles templates, this code must be
+ * available to the compiler when it reads the header file.
+ */
+
+#ifdef _spscqueue_h
+
+/*
+ * Implementation notes: SPSCQueue class
+ * -------------------------------------
+ * The elements live in a circular array whose size is a power of two.
+ * The head and tail indices count up without wrapping, and the slot
+ * for an index is found by masking off its low bits, so the queue is
+ * empty when head == tail and full when tail - head equals the size.
+ *
+ * The producer fills a slot and then publishes it with a release store
+ * to tail; the consumer reads tail with an acquire load before reading
+ * the slot, which guarantees that it sees the element.  The same
+ * pairing in the other direction, through head, tells the producer
+ * when a slot may be reused.  Each thread reads the other's index only
+ * when its cached copy says the queue looks full or empty.
+ */
+
+template <typename ElemType>
+SPSCQueue<ElemType>::SPSCQueue(int capacity) {
+	if (capacity <= 0) Error("SPSCQueue capacity must be positive");
+	unsigned long nSlots = 1;
+	while (nSlots < (unsigned long) capacity) {
+		nSlots *= 2;
+	}
+	elements = new ElemType[nSlots];
+	mask = nSlots - 1;
+	producer.tail.store(0, std::memory_order_relaxed);
+	producer.cachedHead = 0;
+	consumer.head.store(0, std::memory_order_relaxed);
+	consumer.cachedTail = 0;
+}
+
+template <typename ElemType>
+SPSCQueue<ElemType>::~SPSCQueue() {
+	delete[] elements;
+}
+
+template <typename ElemType>
+int SPSCQueue<ElemType>::capacity() {
+	return int(mask + 1);
+}
+
+template <typename ElemType>
+int SPSCQueue<ElemType>::size() {
+	unsigned long head = consumer.head.load(std::memory_order_acquire);
+	unsigned long tail = producer.tail.load(std::memory_order_acquire);
+	return int(tail - head);
+}
+
+template <typename ElemType>
+bool SPSCQueue<ElemType>::isEmpty() {
+	return size() == 0;
+}
+
+template <typename ElemType>
+bool SPSCQueue<ElemType>::tryEnqueue(const ElemType & elem) {
+	unsigned long tail = producer.tail.load(std::memory_order_relaxed);
+	if (tail - producer.cachedHead > mask) {
+		producer.cachedHead = consumer.head.load(std::memory_order_acquire);
+		if (tail - producer.cachedHead > mask) return false;
+	}
+	elements[tail & mask] = elem;
+	producer.tail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename ElemType>
+void SPSCQueue<ElemType>::enqueue(const ElemType & elem) {
+	Backoff backoff;
+	while (!tryEnqueue(elem)) {
+		backoff.pause();
+	}
+}
+
+template <typename ElemType>
+bool SPSCQueue<ElemType>::tryDequeue(ElemType & elem) {
+	unsigned long head = consumer.head.load(std::memory_order_relaxed);
+	if (head == consumer.cachedTail) {
+		consumer.cachedTail = producer.tail.load(std::memory_order_acquire);
+		if (head == consumer.cachedTail) return false;
+	}
+	elem = elements[head & mask];
+	consumer.head.store(head + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename ElemType>
+ElemType SPSCQueue<ElemType>::dequeue() {
+	ElemType elem;
+	Backoff backoff;
+	while (!tryDequeue(elem)) {
+		backoff.pause();
+	}
+	return elem;
+}
+
+#endif
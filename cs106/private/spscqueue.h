@@ -0,0 +1,42 @@
+/*
+ * File: private/spscqueue.h
+ * -----------------------------------------------------
+ * This file contains the private section of the spscqueue.h interface.
+ * This portion of the class definition is taken out of the spscqueue.h
+ * header so that the client need not have to see all of these
+ * details.
+ */
+
+/* Constant definitions */
+	static const int CACHE_LINE_SIZE = 64;
+
+/*
+ * Implementation notes: data layout
+ * ---------------------------------
+ * The tail index is written only by the producer and the head index
+ * only by the consumer.  Each index lives in its own cache line, along
+ * with that thread's private copy of the other thread's index, so the
+ * two threads do not invalidate each other's cache lines except when
+ * one of them actually needs to read the other's progress.  The
+ * alignas specifiers start each of the two structures on a cache line
+ * boundary and round its size up to a whole line, wherever the queue
+ * itself is placed.  A queue allocated with new is aligned as well in
+ * C++17 and later.
+ */
+	struct alignas(CACHE_LINE_SIZE) producerT {
+		std::atomic<unsigned long> tail;   /* Next slot to fill           */
+		unsigned long cachedHead;          /* Last head seen by producer  */
+	};
+
+	struct alignas(CACHE_LINE_SIZE) consumerT {
+		std::atomic<unsigned long> head;   /* Next slot to empty          */
+		unsigned long cachedTail;          /* Last tail seen by consumer  */
+	};
+
+/* Instance variables */
+	ElemType *elements;      /* Circular array of slots                 */
+	unsigned long mask;      /* Number of slots minus one               */
+	producerT producer;
+	consumerT consumer;
+
+	DISALLOW_COPYING(SPSCQueue)
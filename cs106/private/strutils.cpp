@@ -0,0 +1,150 @@
+/*
+ * File: private/strutils.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the range-based
+ * conversion functions in the strutils.h interface.  The rest of
+ * strutils.h is in the precompiled library; these functions are
+ * declared inline so that the code can live in the header.
+ */
+
+#ifdef _strutils_h
+
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <climits>
+
+/*
+ * Implementation notes: FormatInteger
+ * -----------------------------------
+ * The digits are generated two at a time from the lowest end, using
+ * a table that holds the two characters for each value from 00 to 99.
+ * That halves the number of divisions, which are the slow part of the
+ * conversion.  The digits are built at the end of a local array and
+ * then copied to the front of the caller's buffer.
+ */
+
+inline int FormatInteger(int num, char *buffer, int bufferSize) {
+	static const char digitPairs[] =
+		"00010203040506070809" "10111213141516171819"
+		"20212223242526272829" "30313233343536373839"
+		"40414243444546474849" "50515253545556575859"
+		"60616263646566676869" "70717273747576777879"
+		"80818283848586878889" "90919293949596979899";
+	char digits[MAX_INTEGER_CHARS];
+	char *cp = digits + MAX_INTEGER_CHARS;
+	unsigned int value = (num < 0) ? 0u - (unsigned int) num : num;
+	while (value >= 100) {
+		const char *pair = digitPairs + 2 * (value % 100);
+		value /= 100;
+		*--cp = pair[1];
+		*--cp = pair[0];
+	}
+	if (value >= 10) {
+		const char *pair = digitPairs + 2 * value;
+		*--cp = pair[1];
+		*--cp = pair[0];
+	} else {
+		*--cp = char('0' + value);
+	}
+	if (num < 0) *--cp = '-';
+	int n = digits + MAX_INTEGER_CHARS - cp;
+	if (n > bufferSize) Error("FormatInteger: buffer too small");
+	for (int i = 0; i < n; i++) {
+		buffer[i] = cp[i];
+	}
+	return n;
+}
+
+inline int FormatReal(double d, char *buffer, int bufferSize) {
+	char chars[MAX_REAL_CHARS + 1];
+	int n = snprintf(chars, sizeof chars, "%g", d);
+	if (n > bufferSize) Error("FormatReal: buffer too small");
+	for (int i = 0; i < n; i++) {
+		buffer[i] = chars[i];
+	}
+	return n;
+}
+
+/*
+ * Implementation notes: ParseInteger
+ * ----------------------------------
+ * The value is accumulated as an unsigned magnitude.  Before each
+ * digit is added, the magnitude is compared against the largest
+ * value that can still absorb that digit, so that overflow is
+ * detected exactly, including the asymmetric case of INT_MIN.
+ */
+
+inline parseStatusT ParseInteger(const char *chars, int length,
+                                 int & result) {
+	const char *cp = chars;
+	const char *end = chars + length;
+	if (cp == end) return ParseEmpty;
+	bool negative = (*cp == '-');
+	if (*cp == '-' || *cp == '+') cp++;
+	if (cp == end) return ParseBadCharacter;
+	unsigned int limit = negative ? 0u - (unsigned int) INT_MIN : INT_MAX;
+	unsigned int value = 0;
+	for (; cp < end; cp++) {
+		unsigned int digit = (unsigned char) *cp - '0';
+		if (digit > 9) return ParseBadCharacter;
+		if (value > (limit - digit) / 10) {
+			for (cp++; cp < end; cp++) {
+				if (!isdigit((unsigned char) *cp)) return ParseBadCharacter;
+			}
+			return ParseOutOfRange;
+		}
+		value = value * 10 + digit;
+	}
+	result = negative ? -(int) (value - 1) - 1 : (int) value;
+	return ParseOK;
+}
+
+/*
+ * Implementation notes: ParseReal
+ * -------------------------------
+ * Getting the last digit of a real number right is subtle, so ParseReal
+ * leaves the conversion to strtod.  Because the characters need not be
+ * followed by a null character, they are first copied into an array on
+ * the stack, which is large enough for any reasonable number; only
+ * longer inputs are copied into a string.  The characters are checked
+ * first, because strtod also accepts leading spaces and forms such as
+ * "inf" and hexadecimal that StringToReal does not.
+ */
+
+inline parseStatusT ParseReal(const char *chars, int length,
+                              double & result) {
+	if (length == 0) return ParseEmpty;
+	for (int i = 0; i < length; i++) {
+		unsigned char ch = chars[i];
+		if (!isdigit(ch) && ch != '.' && ch != 'e' && ch != 'E'
+		                 && ch != '+' && ch != '-') {
+			return ParseBadCharacter;
+		}
+	}
+	char local[64];
+	string longChars;
+	const char *str = local;
+	if (length < (int) sizeof local) {
+		for (int i = 0; i < length; i++) {
+			local[i] = chars[i];
+		}
+		local[length] = '\0';
+	} else {
+		longChars.assign(chars, length);
+		str = longChars.c_str();
+	}
+	char *end;
+	errno = 0;
+	double value = strtod(str, &end);
+	if (end != str + length) return ParseBadCharacter;
+	if (errno == ERANGE && (value == HUGE_VAL || value == -HUGE_VAL)) {
+		return ParseOutOfRange;
+	}
+	result = value;
+	return ParseOK;
+}
+
+#endif
@@ -0,0 +1,220 @@
+/*
+ * File: private/trace.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the trace.h interface.
+ * The functions are declared inline so that the code can live in the
+ * header, since tracing is not part of the precompiled library.
+ */
+
+#ifdef _trace_h
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+/*
+ * Implementation notes: trace buffers
+ * -----------------------------------
+ * Each thread that records an event gets its own traceBufferT, which
+ * holds the last TRACE_BUFFER_SIZE events in a ring.  Only the owning
+ * thread writes to a buffer, so recording an event takes no lock.  The
+ * buffers are linked into a list in the shared traceStateT the first
+ * time each thread records an event, and they are never freed, so that
+ * the events of a thread that has already finished are still there
+ * when the file is written.  The state is allocated by a function-local
+ * static inside an inline function, which gives the whole program a
+ * single copy no matter how many files include this header.  It is
+ * never destroyed, so that it is still there when TraceStopAtExit runs,
+ * which may be after the destructors of other statics.
+ *
+ * Since only the owner may write to a buffer, TraceStart does not empty
+ * the buffers itself.  It advances the generation in traceStateT, and
+ * each thread empties its own buffer the next time it records an event
+ * and finds that its generation is out of date.  While a thread records
+ * an event, it sets the busy flag in its buffer and then checks that
+ * tracing is still on.  TraceWriteFile turns tracing off first and then
+ * waits for every busy flag to clear, so no thread can write to any
+ * buffer while the events are being read.  Both sides use sequentially
+ * consistent operations, which guarantees that at least one of them
+ * sees what the other has done.
+ */
+
+const int TRACE_BUFFER_SIZE = 1 << 16;
+
+struct traceEventT {
+	const char *name;
+	long long start;
+	long long duration;
+};
+
+struct traceBufferT {
+	traceEventT events[TRACE_BUFFER_SIZE];
+	std::atomic<long long> count;
+	std::atomic<bool> busy;
+	int generation;
+	int thread;
+	traceBufferT *next;
+};
+
+inline void TraceStopAtExit();
+
+inline long long TraceNow() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+	          std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+struct traceStateT {
+	std::mutex lock;
+	std::atomic<bool> on;
+	std::atomic<int> generation;
+	string filename;
+	long long epoch;
+	int nThreads;
+	traceBufferT *buffers;
+
+	traceStateT() {
+		on = false;
+		generation = 0;
+		epoch = TraceNow();
+		nThreads = 0;
+		buffers = NULL;
+		atexit(TraceStopAtExit);
+		const char *env = getenv("CS106_TRACE");
+		if (env != NULL && *env != '\0') {
+			filename = env;
+			on = true;
+		}
+	}
+};
+
+inline traceStateT & TraceState() {
+	static traceStateT & state = *new traceStateT;
+	return state;
+}
+
+inline traceBufferT *TraceThreadBuffer() {
+	static thread_local traceBufferT *buffer = NULL;
+	if (buffer == NULL) {
+		traceStateT & state = TraceState();
+		buffer = new traceBufferT;
+		buffer->count = 0;
+		buffer->busy = false;
+		buffer->generation = state.generation;
+		std::lock_guard<std::mutex> guard(state.lock);
+		buffer->thread = ++state.nThreads;
+		buffer->next = state.buffers;
+		state.buffers = buffer;
+	}
+	return buffer;
+}
+
+inline void TraceStart(string filename) {
+	traceStateT & state = TraceState();
+	std::lock_guard<std::mutex> guard(state.lock);
+	state.generation++;
+	state.filename = filename;
+	state.epoch = TraceNow();
+	state.on = true;
+}
+
+inline bool TraceIsOn() {
+	return TraceState().on.load(std::memory_order_relaxed);
+}
+
+/*
+ * Implementation notes: TraceStop
+ * -------------------------------
+ * Each event is written as a "complete" event (phase "X"), which gives
+ * the start and duration in microseconds.  The viewer works out the
+ * nesting from the times, so the events can be written in any order.
+ * TraceWriteFile returns a message instead of raising an error, since
+ * TraceStopAtExit runs from atexit, where an exception would end the
+ * program with std::terminate.
+ */
+
+inline string TraceWriteFile() {
+	traceStateT & state = TraceState();
+	std::lock_guard<std::mutex> guard(state.lock);
+	if (!state.on) return "";
+	state.on = false;
+	for (traceBufferT *bp = state.buffers; bp != NULL; bp = bp->next) {
+		while (bp->busy) {
+			std::this_thread::yield();
+		}
+	}
+	ofstream out(state.filename.c_str());
+	if (out.fail()) return "Can't open trace file " + state.filename;
+	out << "{\"traceEvents\":[";
+	char line[128];
+	bool first = true;
+	for (traceBufferT *bp = state.buffers; bp != NULL; bp = bp->next) {
+		long long count = bp->count.load(std::memory_order_acquire);
+		long long oldest = max(count - TRACE_BUFFER_SIZE, 0LL);
+		for (long long i = oldest; i < count; i++) {
+			traceEventT & event = bp->events[i & (TRACE_BUFFER_SIZE - 1)];
+			if (event.start < state.epoch) continue;
+			out << (first ? "\n" : ",\n") << "{\"name\":\"";
+			for (const char *cp = event.name; *cp != '\0'; cp++) {
+				if (*cp == '"' || *cp == '\\') out << '\\';
+				out << *cp;
+			}
+			snprintf(line, sizeof line,
+			         "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+			         (event.start - state.epoch) / 1000.0,
+			         event.duration / 1000.0, bp->thread);
+			out << line;
+			first = false;
+		}
+	}
+	out << "\n],\"displayTimeUnit\":\"ms\"}" << endl;
+	if (out.fail()) return "Can't write trace file " + state.filename;
+	return "";
+}
+
+inline void TraceStop() {
+	string message = TraceWriteFile();
+	if (message != "") Error(message);
+}
+
+inline void TraceStopAtExit() {
+	string message = TraceWriteFile();
+	if (message != "") cerr << message << endl;
+}
+
+inline TraceScope::TraceScope(const char *name) {
+	if (TraceIsOn()) {
+		this->name = name;
+		start = TraceNow();
+	} else {
+		this->name = NULL;
+	}
+}
+
+inline TraceScope::~TraceScope() {
+	if (name == NULL) return;
+	long long finish = TraceNow();
+	traceStateT & state = TraceState();
+	traceBufferT *bp = TraceThreadBuffer();
+	bp->busy = true;
+	if (state.on) {
+		long long count = bp->count.load(std::memory_order_relaxed);
+		int generation = state.generation;
+		if (bp->generation != generation) {
+			bp->generation = generation;
+			count = 0;
+		}
+		traceEventT & event = bp->events[count & (TRACE_BUFFER_SIZE - 1)];
+		event.name = name;
+		event.start = start;
+		event.duration = finish - start;
+		bp->count.store(count + 1, std::memory_order_release);
+	}
+	bp->busy.store(false, std::memory_order_release);
+}
+
+#endif
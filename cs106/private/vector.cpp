@@ -14,11 +14,13 @@
  * ---------------------------
  * The Vector is internally managed as a dynamic array of elements.
  * It tracks capacity (numAllocated) separately from size (numUsed).
- * All access is bounds-checked for safety.
+ * All access is bounds-checked for safety unless VECTOR_CHECKS is 0,
+ * as described in private/checks.h.
  */
 
 template <typename ElemType>
 Vector<ElemType>::Vector(int capacity) {
+	INSTRUMENT_EVENT("Vector", AllocationEvent, capacity * sizeof(ElemType));
 	elements = new ElemType[capacity];
 	numAllocated = capacity;
 	numUsed = 0;
@@ -42,13 +44,13 @@ bool Vector<ElemType>::isEmpty() {
 
 template <typename ElemType>
 ElemType Vector<ElemType>::getAt(int index) {
-	checkRange(index, "getAt");
+	if (VECTOR_CHECKS) checkRange(index, "getAt");
 	return elements[index];
 }
 
 template <typename ElemType>
 void Vector<ElemType>::setAt(int index, ElemType elem) {
-	checkRange(index, "setAt");
+	if (VECTOR_CHECKS) checkRange(index, "setAt");
 	elements[index] = elem;
 }
 
@@ -70,7 +72,7 @@ inline void Vector<ElemType>::checkRange(int index, const char *verb) {
 
 template <typename ElemType>
 inline ElemType &Vector<ElemType>::operator[](int index) {
-	checkRange(index, "access");
+	if (VECTOR_CHECKS) checkRange(index, "access");
 	return elements[index];
 }
 
@@ -129,7 +131,7 @@ template <typename ElemType>
 void Vector<ElemType>::mapAll(void (*fn)(ElemType)) {
 	long t0 = timestamp;
 	for (int i = 0; i < numUsed; i++) {
-		if (timestamp != t0) {
+		if (VECTOR_CHECKS && timestamp != t0) {
 			Error("Vector structure has been modified");
 		}
 		fn(elements[i]);
@@ -142,7 +144,7 @@ void Vector<ElemType>::mapAll(void (*fn)(ElemType, ClientDataType&),
                               ClientDataType & data) {
 	long t0 = timestamp;
 	for (int i = 0; i < numUsed; i++) {
-		if (timestamp != t0) {
+		if (VECTOR_CHECKS && timestamp != t0) {
 			Error("Vector structure has been modified");
 		}
 		fn(elements[i], data);
@@ -176,7 +178,7 @@ Vector<ElemType>::Iterator::Iterator(Vector *vecRef) {
 template <typename ElemType>
 bool Vector<ElemType>::Iterator::hasNext() {
 	if (vp == NULL) Error("hasNext called on uninitialized iterator");
-	if (timestamp != vp->timestamp) {
+	if (VECTOR_CHECKS && timestamp != vp->timestamp) {
 		Error("Vector structure has been modified");
 	}
 	return curIndex < vp->size();
@@ -194,7 +196,10 @@ ElemType Vector<ElemType>::Iterator::next() {
 
 template <typename ElemType>
 ElemType Vector<ElemType>::foreachHook(FE_State & fe) {
-	if (fe.state == 0) fe.iter = new Iterator(this);
+	if (fe.state == 0) {
+		INSTRUMENT_EVENT("Vector", IteratorEvent, 0);
+		fe.iter = new Iterator(this);
+	}
 	if (((Iterator *) fe.iter)->hasNext()) {
 		fe.state = 1;
 		return ((Iterator *) fe.iter)->next();
@@ -213,6 +218,8 @@ ElemType Vector<ElemType>::foreachHook(FE_State & fe) {
 template <typename ElemType>
 void Vector<ElemType>::enlargeCapacity() {
 	numAllocated = (numAllocated == 0 ? 10 : numAllocated*2);
+	INSTRUMENT_EVENT("Vector", GrowEvent, 0);
+	INSTRUMENT_EVENT("Vector", AllocationEvent, numAllocated * sizeof(ElemType));
 	ElemType *newArray = new ElemType[numAllocated];
 	for (int i = 0; i < numUsed; i++) {
 		newArray[i] = elements[i];
@@ -229,6 +236,8 @@ void Vector<ElemType>::enlargeCapacity() {
 
 template <typename ElemType>
 void Vector<ElemType>::copyInternalData(const Vector & other) {
+	INSTRUMENT_EVENT("Vector", CopyEvent, 0);
+	INSTRUMENT_EVENT("Vector", AllocationEvent, other.numUsed * sizeof(ElemType));
 	elements = new ElemType[other.numUsed];
 	for (int i = 0; i < other.numUsed; i++) {
 		elements[i] = other.elements[i];
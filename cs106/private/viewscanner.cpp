@@ -0,0 +1,249 @@
+/*
+ * File: private/viewscanner.cpp
+ * -----------------------------------------------------
+ * This file contains the implementation of the viewscanner.h
+ * interface.  The methods are declared inline so that the code
+ * can live in the header, since the scanner is not part of the
+ * precompiled library.
+ */
+
+#ifdef _viewscanner_h
+
+/*
+ * ViewScanner class implementation
+ * --------------------------------
+ * The scanner keeps a pointer to the input characters, their length,
+ * and the index cp of the next character to scan.  A token is just a
+ * range of that input, so nextToken finds where the token ends and
+ * returns the range.  The number methods find the range the same way
+ * and convert it without building a string.
+ */
+
+inline ViewScanner::ViewScanner() {
+	chars = "";
+	length = cp = 0;
+	nSaved = 0;
+	spaceOption = PreserveSpaces;
+	numberOption = ScanNumbersAsLetters;
+	stringOption = ScanQuotesAsPunctuation;
+}
+
+inline ViewScanner::~ViewScanner() {
+	releaseInput();
+}
+
+inline void ViewScanner::setInput(const char *chars, int length) {
+	if (length < 0) Error("setInput: negative length");
+	releaseInput();
+	this->chars = chars;
+	this->length = length;
+}
+
+inline void ViewScanner::setInput(const string & str) {
+	setInput(str.data(), str.length());
+}
+
+inline bool ViewScanner::mapFile(string filename) {
+	releaseInput();
+	if (!file.open(filename)) return false;
+	chars = file.data();
+	length = file.size();
+	return true;
+}
+
+inline tokenViewT ViewScanner::nextToken() {
+	if (nSaved > 0) return savedTokens[--nSaved];
+	if (spaceOption == IgnoreSpaces) skipSpaces();
+	int start = cp;
+	if (cp < length) {
+		unsigned char ch = chars[cp];
+		if (ch == '"' && stringOption == ScanQuotesAsStrings) {
+			cp = scanToEndOfString();
+		} else if (isdigit(ch) && numberOption == ScanNumbersAsIntegers) {
+			cp = scanToEndOfInteger();
+		} else if (isdigit(ch) && numberOption == ScanNumbersAsReals) {
+			cp = scanToEndOfReal();
+		} else if (isalnum(ch)) {
+			cp = scanToEndOfIdentifier();
+		} else {
+			cp++;
+		}
+	}
+	tokenViewT token;
+	token.start = chars + start;
+	token.length = cp - start;
+	return token;
+}
+
+inline bool ViewScanner::hasMoreTokens() {
+	if (nSaved > 0) return true;
+	if (spaceOption == IgnoreSpaces) skipSpaces();
+	return cp < length;
+}
+
+inline void ViewScanner::saveToken(tokenViewT token) {
+	if (nSaved == MAX_SAVED_TOKENS) {
+		Error("saveToken: too many saved tokens");
+	}
+	savedTokens[nSaved++] = token;
+}
+
+inline int ViewScanner::nextInteger() {
+	tokenViewT token = nextNumberToken(false);
+	int value = 0;
+	parseStatusT status = ParseInteger(token.start, token.length, value);
+	if (status != ParseOK) numberError("an integer", token, status);
+	return value;
+}
+
+inline double ViewScanner::nextReal() {
+	tokenViewT token = nextNumberToken(true);
+	double value = 0;
+	parseStatusT status = ParseReal(token.start, token.length, value);
+	if (status != ParseOK) numberError("a real number", token, status);
+	return value;
+}
+
+inline void ViewScanner::setSpaceOption(spaceOptionT option) {
+	spaceOption = option;
+}
+
+inline ViewScanner::spaceOptionT ViewScanner::getSpaceOption() {
+	return spaceOption;
+}
+
+inline void ViewScanner::setNumberOption(numberOptionT option) {
+	numberOption = option;
+}
+
+inline ViewScanner::numberOptionT ViewScanner::getNumberOption() {
+	return numberOption;
+}
+
+inline void ViewScanner::setStringOption(stringOptionT option) {
+	stringOption = option;
+}
+
+inline ViewScanner::stringOptionT ViewScanner::getStringOption() {
+	return stringOption;
+}
+
+/*
+ * Private method: releaseInput
+ * Usage: releaseInput();
+ * ----------------------
+ * Unmaps any mapped file and resets the scanner to an empty input.
+ */
+
+inline void ViewScanner::releaseInput() {
+	file.close();
+	chars = "";
+	length = cp = 0;
+	nSaved = 0;
+}
+
+inline void ViewScanner::skipSpaces() {
+	while (cp < length && isspace((unsigned char) chars[cp])) {
+		cp++;
+	}
+}
+
+inline int ViewScanner::scanToEndOfIdentifier() {
+	int finish = cp;
+	while (finish < length && isalnum((unsigned char) chars[finish])) {
+		finish++;
+	}
+	return finish;
+}
+
+inline int ViewScanner::scanToEndOfInteger() {
+	int finish = cp;
+	while (finish < length && isdigit((unsigned char) chars[finish])) {
+		finish++;
+	}
+	return finish;
+}
+
+/*
+ * Private method: scanToEndOfReal
+ * Usage: int finish = scanToEndOfReal();
+ * --------------------------------------
+ * Returns the index just past the longest real number starting at cp:
+ * digits with at most one decimal point, optionally followed by an
+ * exponent.  An 'E' that is not followed by an exponent is left for
+ * the next token.
+ */
+
+inline int ViewScanner::scanToEndOfReal() {
+	int finish = cp;
+	while (finish < length && isdigit((unsigned char) chars[finish])) {
+		finish++;
+	}
+	if (finish < length && chars[finish] == '.') {
+		finish++;
+		while (finish < length && isdigit((unsigned char) chars[finish])) {
+			finish++;
+		}
+	}
+	if (finish < length && (chars[finish] == 'e' || chars[finish] == 'E')) {
+		int exp = finish + 1;
+		if (exp < length && (chars[exp] == '+' || chars[exp] == '-')) exp++;
+		if (exp < length && isdigit((unsigned char) chars[exp])) {
+			while (exp < length && isdigit((unsigned char) chars[exp])) {
+				exp++;
+			}
+			finish = exp;
+		}
+	}
+	return finish;
+}
+
+/*
+ * Private method: scanToEndOfString
+ * Usage: int finish = scanToEndOfString();
+ * ----------------------------------------
+ * Returns the index just past the closing quotation mark of the
+ * string starting at cp, skipping over escaped characters.  Raises
+ * an error if the string is not closed.
+ */
+
+inline int ViewScanner::scanToEndOfString() {
+	int finish = cp + 1;
+	while (finish < length && chars[finish] != '"') {
+		if (chars[finish] == '\\') finish++;
+		finish++;
+	}
+	if (finish >= length) Error("Unterminated string");
+	return finish + 1;
+}
+
+/*
+ * Private method: nextNumberToken
+ * Usage: tokenViewT token = nextNumberToken(isReal);
+ * --------------------------------------------------
+ * Returns the token for nextInteger or nextReal, which is a saved
+ * token if there is one and otherwise an optional sign followed by
+ * the longest integer or real number at cp.
+ */
+
+inline tokenViewT ViewScanner::nextNumberToken(bool isReal) {
+	if (nSaved > 0) return savedTokens[--nSaved];
+	if (spaceOption == IgnoreSpaces) skipSpaces();
+	int start = cp;
+	if (cp < length && (chars[cp] == '-' || chars[cp] == '+')) cp++;
+	cp = isReal ? scanToEndOfReal() : scanToEndOfInteger();
+	tokenViewT token;
+	token.start = chars + start;
+	token.length = cp - start;
+	return token;
+}
+
+inline void ViewScanner::numberError(const char *kind, tokenViewT token,
+                                     parseStatusT status) {
+	if (status == ParseOutOfRange) {
+		Error("Number \"" + token.str() + "\" is out of range");
+	}
+	Error(string("Expected ") + kind + " but found \"" + token.str() + "\"");
+}
+
+#endif
@@ -0,0 +1,38 @@
+/*
+ * File: private/viewscanner.h
+ * -----------------------------------------------------
+ * This file contains the private section of the viewscanner.h
+ * interface.  This portion of the class definition is taken out of
+ * the viewscanner.h header so that the client need not have to see
+ * all of these details.
+ */
+
+/*
+ * Saved tokens
+ * ------------
+ * Tokens passed to saveToken are kept in a small fixed array so that
+ * saving and rereading them never allocates memory.
+ */
+	static const int MAX_SAVED_TOKENS = 8;
+
+	const char *chars;
+	int length;
+	int cp;
+	MappedFile file;
+	spaceOptionT spaceOption;
+	numberOptionT numberOption;
+	stringOptionT stringOption;
+	tokenViewT savedTokens[MAX_SAVED_TOKENS];
+	int nSaved;
+
+	void releaseInput();
+	void skipSpaces();
+	int scanToEndOfIdentifier();
+	int scanToEndOfInteger();
+	int scanToEndOfReal();
+	int scanToEndOfString();
+	tokenViewT nextNumberToken(bool isReal);
+	void numberError(const char *kind, tokenViewT token,
+	                 parseStatusT status);
+
+	DISALLOW_COPYING(ViewScanner)
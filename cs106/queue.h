@@ -11,6 +11,7 @@
 #define _queue_h
 
 #include "genlib.h"
+#include "instrument.h"
 
 /*
  * Class: Queue
@@ -24,6 +25,10 @@
  * For maximum generality, the Queue is supplied as a class template.
  * The client specializes the queue to hold values of a specific type,
  * e.g. Queue<customerT> or Queue<string>, as needed
+ *
+ * The elements are stored in a circular array that grows as needed,
+ * so once the queue has reached its working size, enqueue and dequeue
+ * do not allocate memory.
  */
 
 template <typename ElemType>
@@ -86,6 +91,21 @@ public:
  */
     ElemType dequeue();
 
+/*
+ * Methods: enqueueAll, dequeueAll
+ * Usage: queue.enqueueAll(array, n);
+ *        n = queue.dequeueAll(array, maxElems);
+ * ---------------------------------------------
+ * These methods move many elements at once.  The enqueueAll method
+ * adds the first n elements of array to the end of this queue, in
+ * order.  The dequeueAll method removes up to maxElems elements from
+ * the front of this queue, stores them in order in array, and returns
+ * the number removed, which is zero if the queue is empty.  Each call
+ * copies the elements in at most two contiguous runs.
+ */
+    void enqueueAll(const ElemType array[], int n);
+    int dequeueAll(ElemType array[], int maxElems);
+
 /*
  * Method: peek
  * Usage: first = queue.peek();
@@ -101,7 +121,8 @@ public:
  * Usage: queue.clear();
  * ---------------------
  * This method removes all elements from this queue. The
- * queue is made empty and will have size() = 0.
+ * queue is made empty and will have size() = 0.  The storage
+ * is kept for reuse by later calls to enqueue.
  */
     void clear();
 
@@ -11,6 +11,9 @@
 #ifndef _random_h
 #define _random_h
 
+#include "genlib.h"
+#include <stdint.h>
+
 /*
  * Function: Randomize
  * Usage: Randomize();
@@ -68,4 +71,120 @@ bool RandomChance(double p);
 
 void SetRandomSeed(int seed);
 
+/*
+ * Class: RandomGenerator
+ * ----------------------
+ * The functions above all draw from a single shared sequence, which
+ * makes them awkward to use from several threads at once and makes
+ * it hard to reproduce one part of a program's random behavior
+ * without reproducing all of it.  A RandomGenerator object is an
+ * independent source of random numbers with its own seed:
+ *
+ *      RandomGenerator rng(42);
+ *      int roll = rng.nextInteger(1, 6);
+ *
+ * Two generators with the same seed produce the same sequence, on
+ * every platform.  The generator uses the xoshiro256** algorithm,
+ * which is much faster than rand() and has far better statistical
+ * quality.  Copying a generator copies its position in the sequence,
+ * so the copy produces the same values as the original.
+ *
+ * To give each of several threads its own sequence, create one
+ * generator and then derive the others by copying and calling jump,
+ * which guarantees that the sequences never overlap:
+ *
+ *      RandomGenerator streams[N_THREADS];
+ *      streams[0].setSeed(seed);
+ *      for (int i = 1; i < N_THREADS; i++) {
+ *          streams[i] = streams[i - 1];
+ *          streams[i].jump();
+ *      }
+ *
+ * A single generator must not be used by two threads at once.
+ */
+
+class RandomGenerator {
+
+public:
+
+/*
+ * Constructor: RandomGenerator
+ * Usage: RandomGenerator rng;
+ *        RandomGenerator rng(seed);
+ * ---------------------------------
+ * The constructor initializes a new generator with the given seed.
+ * If no seed is given, the generator uses a fixed default seed, so
+ * that program behavior is repeatable until randomize is called.
+ */
+	RandomGenerator();
+	explicit RandomGenerator(uint64_t seed);
+
+/*
+ * Methods: setSeed, randomize
+ * Usage: rng.setSeed(seed);
+ *        rng.randomize();
+ * ------------------------
+ * The setSeed method restarts this generator at the beginning of
+ * the sequence for the given seed.  The randomize method chooses
+ * a seed that differs from run to run, like Randomize.
+ */
+	void setSeed(uint64_t seed);
+	void randomize();
+
+/*
+ * Methods: nextInteger, nextReal, nextChance
+ * Usage: n = rng.nextInteger(low, high);
+ *        d = rng.nextReal(low, high);
+ *        if (rng.nextChance(p)) . . .
+ * -------------------------------------
+ * These methods are the RandomGenerator counterparts of RandomInteger,
+ * RandomReal, and RandomChance, with the same ranges.  Every integer
+ * from low to high is exactly equally likely.  The nextInteger method
+ * signals an error if low is greater than high.
+ */
+	int nextInteger(int low, int high);
+	double nextReal(double low, double high);
+	bool nextChance(double p);
+
+/*
+ * Method: nextBits
+ * Usage: uint64_t bits = rng.nextBits();
+ * --------------------------------------
+ * This method returns the next 64 random bits from the sequence.
+ */
+	uint64_t nextBits();
+
+/*
+ * Methods: fillIntegers, fillReals
+ * Usage: rng.fillIntegers(array, n, low, high);
+ *        rng.fillReals(array, n, low, high);
+ * ------------------------------------------
+ * These methods store n random values into the first n elements of
+ * array.  The values are exactly the ones that n calls to nextInteger
+ * or nextReal would produce, but the generator stays in registers for
+ * the whole loop, which makes filling large arrays much faster.
+ */
+	void fillIntegers(int array[], int n, int low, int high);
+	void fillReals(double array[], int n, double low, double high);
+
+/*
+ * Method: jump
+ * Usage: rng.jump();
+ * ------------------
+ * This method advances this generator by 2^128 steps, as if nextBits
+ * had been called that many times.  It takes the same short time as
+ * a few hundred calls to nextBits.  The sequences before and after
+ * a jump will not overlap in any realistic program, which makes jump
+ * the way to split one seed into independent streams.
+ */
+	void jump();
+
+private:
+
+#include "private/random.h"
+
+};
+
+#include "private/random.cpp"
+
 #endif
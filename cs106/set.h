@@ -14,6 +14,7 @@
 #include "bst.h"
 #include "vector.h"
 #include "foreach.h"
+#include "instrument.h"
 
 /*
  * Class: Set
@@ -28,9 +29,15 @@
  * client must supply a comparison function that compares two elements
  * (or be willing to use the default comparison function that uses
  * the built-on operators  < and ==).
+ *
+ * As with BST, the optional second template argument selects the
+ * comparator class from cmpfn.h.  Declaring a set as
+ * Set<string, OperatorComparator<string> > makes the comparisons
+ * inline and copy-free for types that have a natural ordering.
  */
 
-template <typename ElemType>
+template <typename ElemType,
+          typename Comparator = FunctionComparator<ElemType> >
 class Set {
 
 public:
@@ -52,9 +59,11 @@ public:
  * and a positive resut if first is "greater than" second. If
  * no argument is supplied, the OperatorCmp template is used as
  * a default, which applies the bulit-in < and == to the
- * elements to determine ordering.
+ * elements to determine ordering.  If the set uses a comparator
+ * class other than the default, the argument is an object of that
+ * class.
  */
-	Set(int (*cmpFn)(ElemType, ElemType) = OperatorCmp);
+	Set(Comparator cmpFn = Comparator());
 
 /*
  * Destructor: ~Set
@@ -90,7 +99,7 @@ public:
  * overwritten by the new copy, and the set's size is unchanged.
  * Otherwise, the value is added and set's size increases by one.
  */
-	void add(ElemType elem);
+	void add(const ElemType & elem);
 
 /*
  * Method: remove
@@ -101,7 +110,7 @@ public:
  * Otherwise, the element is removed and the set's size decreases
  * by one.
  */
-	void remove(ElemType elem);
+	void remove(const ElemType & elem);
 
 /*
  * Method: contains
@@ -109,7 +118,7 @@ public:
  * -----------------------------------
  * Returns true if the element in this set, false otherwise.
  */
-	bool contains(ElemType elem);
+	bool contains(const ElemType & elem);
 
 /*
  * Method: find
@@ -120,7 +129,7 @@ public:
  * in place. If element is not contained in this set, NULL is
  * returned.
  */
-	ElemType *find(ElemType elem);
+	ElemType *find(const ElemType & elem);
 
 /*
  * Method: equals
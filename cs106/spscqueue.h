@@ -0,0 +1,121 @@
+/*
+ * File: spscqueue.h
+ * -----------------------------------------------------
+ * This interface file contains the SPSCQueue class template, a
+ * bounded queue for passing values from one thread to another.
+ */
+
+#ifndef _spscqueue_h
+#define _spscqueue_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "private/backoff.h"
+#include <atomic>
+
+/*
+ * Class: SPSCQueue
+ * ----------------
+ * This interface defines a first-in-first-out queue that can be
+ * shared by exactly two threads: a producer, which is the only thread
+ * that calls the enqueue methods, and a consumer, which is the only
+ * thread that calls the dequeue methods.  The queue holds at most a
+ * fixed number of elements, chosen when it is created, and never
+ * allocates memory after that.  It uses no locks; each operation is a
+ * few loads and stores, so it can hand off millions of elements per
+ * second between pipeline stages.
+ *
+ * Each operation comes in two forms.  The try methods return false
+ * immediately if the queue is full (for tryEnqueue) or empty (for
+ * tryDequeue).  The plain methods wait until the operation can be
+ * done, spinning briefly and then yielding the processor.
+ *
+ * If more than one thread needs to enqueue or dequeue, use MPMCQueue
+ * instead.  SPSCQueue objects cannot be copied.
+ */
+
+template <typename ElemType>
+class SPSCQueue {
+
+public:
+
+/*
+ * Constructor: SPSCQueue
+ * Usage: SPSCQueue<int> queue(1024);
+ * ----------------------------------
+ * The constructor initializes a new empty queue that can hold at least
+ * capacity elements.  The capacity is rounded up to a power of two.
+ */
+	explicit SPSCQueue(int capacity);
+
+/*
+ * Destructor: ~SPSCQueue
+ * Usage: delete qp;
+ * -----------------
+ * The destructor deallocates storage associated with this queue.
+ * No other thread may be using the queue when it is deleted.
+ */
+	~SPSCQueue();
+
+/*
+ * Method: capacity
+ * Usage: n = queue.capacity();
+ * ----------------------------
+ * This method returns the maximum number of elements the queue holds.
+ */
+	int capacity();
+
+/*
+ * Method: size
+ * Usage: nElems = queue.size();
+ * -----------------------------
+ * This method returns the number of elements in this queue.  While
+ * the other thread is active, the result is only a snapshot.
+ */
+	int size();
+
+/*
+ * Method: isEmpty
+ * Usage: if (queue.isEmpty())...
+ * -------------------------------
+ * This method returns true if this queue contains no elements, with
+ * the same caveat as size.
+ */
+	bool isEmpty();
+
+/*
+ * Methods: tryEnqueue, enqueue
+ * Usage: if (queue.tryEnqueue(elem))...
+ *        queue.enqueue(elem);
+ * -------------------------------------
+ * These methods add elem to the end of this queue.  If the queue is
+ * full, tryEnqueue returns false without adding it, and enqueue waits
+ * until the consumer makes room.  Only the producer thread may call
+ * these methods.
+ */
+	bool tryEnqueue(const ElemType & elem);
+	void enqueue(const ElemType & elem);
+
+/*
+ * Methods: tryDequeue, dequeue
+ * Usage: if (queue.tryDequeue(elem))...
+ *        elem = queue.dequeue();
+ * -------------------------------------
+ * These methods remove the front element from this queue.  The
+ * tryDequeue method stores it in its argument and returns true, or
+ * returns false if the queue is empty.  The dequeue method returns
+ * the element, waiting for the producer if the queue is empty.  Only
+ * the consumer thread may call these methods.
+ */
+	bool tryDequeue(ElemType & elem);
+	ElemType dequeue();
+
+private:
+
+#include "private/spscqueue.h"
+
+};
+
+#include "private/spscqueue.cpp"
+
+#endif
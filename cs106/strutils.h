@@ -78,4 +78,73 @@ string ConvertToLowerCase(string s);
 
 string ConvertToUpperCase(string s);
 
+/*
+ * Type: parseStatusT
+ * ------------------
+ * This enumerated type is the result of ParseInteger and ParseReal.
+ * ParseOK means that the conversion succeeded, ParseEmpty that there
+ * were no characters to convert, ParseBadCharacter that the characters
+ * do not form a number of the right kind, and ParseOutOfRange that
+ * the number is too large in magnitude for the result type.
+ */
+
+enum parseStatusT { ParseOK, ParseEmpty, ParseBadCharacter, ParseOutOfRange };
+
+/*
+ * Function: FormatInteger
+ * Usage: int n = FormatInteger(num, buffer, bufferSize);
+ * ------------------------------------------------------
+ * This function writes the digits of num, preceded by a minus sign if
+ * num is negative, into the first characters of buffer and returns the
+ * number of characters written.  It does not add a null character and
+ * never allocates memory.  FormatInteger signals an error if the
+ * result does not fit in bufferSize characters; a buffer of
+ * MAX_INTEGER_CHARS characters is always large enough.
+ */
+
+const int MAX_INTEGER_CHARS = 11;
+
+int FormatInteger(int num, char *buffer, int bufferSize);
+
+/*
+ * Function: FormatReal
+ * Usage: int n = FormatReal(d, buffer, bufferSize);
+ * -------------------------------------------------
+ * This function writes d into buffer in the same form as RealToString
+ * and returns the number of characters written, which is at most
+ * MAX_REAL_CHARS.  As with FormatInteger, no null character is added,
+ * and an error is signaled if the result does not fit.
+ */
+
+const int MAX_REAL_CHARS = 32;
+
+int FormatReal(double d, char *buffer, int bufferSize);
+
+/*
+ * Function: ParseInteger
+ * Usage: if (ParseInteger(chars, length, n) == ParseOK) . . .
+ * -----------------------------------------------------------
+ * This function converts the length characters starting at chars,
+ * which need not be followed by a null character, into an integer
+ * that it stores in result.  The characters must consist of an
+ * optional sign followed by digits and nothing else.  Instead of
+ * signaling an error, ParseInteger returns a parseStatusT that says
+ * exactly what went wrong; result is changed only on success.
+ */
+
+parseStatusT ParseInteger(const char *chars, int length, int & result);
+
+/*
+ * Function: ParseReal
+ * Usage: if (ParseReal(chars, length, d) == ParseOK) . . .
+ * --------------------------------------------------------
+ * This function is the ParseInteger counterpart of StringToReal.
+ * The characters must form a legal floating-point number with no
+ * extraneous characters.
+ */
+
+parseStatusT ParseReal(const char *chars, int length, double & result);
+
+#include "private/strutils.cpp"
+
 #endif
@@ -0,0 +1,99 @@
+/*
+ * File: trace.h
+ * -----------------------------------------------------
+ * This interface exports a lightweight tracer that records how long
+ * each labeled part of a program takes and writes the results as a
+ * trace-event JSON file, which can be opened in a timeline viewer such
+ * as chrome://tracing or ui.perfetto.dev.
+ *
+ * The client marks the parts of the program it wants to see with
+ * TRACE_SCOPE:
+ *
+ *      void solveRec(. . .) {
+ *          TRACE_SCOPE("solveRec");
+ *          . . .
+ *      }
+ *
+ * Each time control leaves the enclosing block, the tracer records one
+ * event with the name, the start time and the duration.  Scopes can be
+ * nested, including through recursive calls, and the viewer draws the
+ * nested events below the ones that contain them.
+ *
+ * Tracing is off unless it is turned on, either by setting the
+ * environment variable CS106_TRACE to the name of the output file
+ * before the program starts, or by calling TraceStart.  While tracing
+ * is off, a TRACE_SCOPE costs a single test of a flag.  While it is on,
+ * each thread records its events in its own fixed-size ring buffer, so
+ * threads never wait for each other; if a buffer fills up, the oldest
+ * events in it are overwritten.  The file is written by TraceStop, or
+ * when the program exits if tracing is still on, in which case a file
+ * that cannot be written is reported on cerr.
+ */
+
+#ifndef _trace_h
+#define _trace_h
+
+#include "genlib.h"
+
+/*
+ * Macro: TRACE_SCOPE
+ * Usage: TRACE_SCOPE("findPuzzleBorder");
+ * ---------------------------------------
+ * This macro records the time from this point to the end of the
+ * enclosing block as an event with the given name, which must be a
+ * string literal or other string that lasts until the trace is written.
+ */
+
+#define TRACE_SCOPE(name) TraceScope _traceScope(name)
+
+/*
+ * Function: TraceStart
+ * Usage: TraceStart("solve.json");
+ * --------------------------------
+ * This function turns tracing on, discarding any events recorded so
+ * far, and sets the name of the file that TraceStop writes.
+ */
+
+void TraceStart(string filename);
+
+/*
+ * Function: TraceStop
+ * Usage: TraceStop();
+ * -------------------
+ * This function turns tracing off and writes the events recorded since
+ * tracing was turned on to the output file.  Threads that record events
+ * should be finished or idle when it is called.  Raises an error if the
+ * file cannot be written.
+ */
+
+void TraceStop();
+
+/*
+ * Function: TraceIsOn
+ * Usage: if (TraceIsOn()) . . .
+ * -----------------------------
+ * This function returns true if tracing is on.
+ */
+
+bool TraceIsOn();
+
+/*
+ * Class: TraceScope
+ * -----------------
+ * This class implements TRACE_SCOPE.  Constructing an object notes the
+ * time if tracing is on, and destroying it records the event.
+ */
+
+class TraceScope {
+public:
+	TraceScope(const char *name);
+	~TraceScope();
+
+private:
+	const char *name;
+	long long start;
+};
+
+#include "private/trace.cpp"
+
+#endif
@@ -13,6 +13,8 @@
 #include "genlib.h"
 #include "strutils.h"
 #include "foreach.h"
+#include "instrument.h"
+#include "private/checks.h"
 
 /*
  * Class: Vector
@@ -25,6 +27,10 @@
  * For maximum generality, the Vector is supplied as a class template.
  * The client specializes the vector to hold values of a specific
  * type, e.g. Vector<int> or Vector<studentT>, as needed
+ *
+ * In builds that define NDEBUG, the bounds checks on element access
+ * are compiled out; private/checks.h explains how to control this
+ * with the CS106_CHECKS and VECTOR_CHECKS macros.
  */
 
 template <typename ElemType>
@@ -0,0 +1,207 @@
+/*
+ * File: viewscanner.h
+ * -----------------------------------------------------
+ * This interface exports the ViewScanner class, a variant of the
+ * Scanner class that divides a block of characters into tokens
+ * without copying it.  The characters come either from a buffer
+ * owned by the client or from a file that the scanner maps into
+ * memory, and each token is returned as a tokenViewT that points
+ * back into those characters.  Because nothing is copied, scanning
+ * a large input requires no dynamic allocation at all.
+ *
+ * The following code fragment reads all the integers in a file:
+ *
+ *      ViewScanner scanner;
+ *      scanner.setSpaceOption(ViewScanner::IgnoreSpaces);
+ *      if (!scanner.mapFile("data.txt")) Error("Can't open data.txt");
+ *      while (scanner.hasMoreTokens()) {
+ *          int n = scanner.nextInteger();
+ *          . . . process n . . .
+ *      }
+ *
+ * The rules for dividing the input into tokens are the same as those
+ * used by Scanner, and the spaceOption, numberOption, and stringOption
+ * settings work as described in scanner.h.  ViewScanner does not
+ * support the bracket option.
+ */
+
+#ifndef _viewscanner_h
+#define _viewscanner_h
+
+#include "genlib.h"
+#include "disallowcopy.h"
+#include "strutils.h"
+#include "private/mappedfile.h"
+#include <string>
+#include <cctype>
+
+/*
+ * Type: tokenViewT
+ * ----------------
+ * This type describes a token as the length characters starting
+ * at start.  The characters belong to the scanner's input and are
+ * not followed by a null character, so a tokenViewT remains valid
+ * only as long as that input does.  The str method makes a string
+ * copy of the token for clients that need to keep it longer.
+ */
+
+struct tokenViewT {
+	const char *start;
+	int length;
+	string str() const { return string(start, length); }
+};
+
+/*
+ * Class: ViewScanner
+ * ------------------
+ * This class is used to represent a single instance of a scanner
+ * over a borrowed or memory-mapped buffer.
+ */
+
+class ViewScanner {
+public:
+
+/*
+ * Constructor: ViewScanner
+ * Usage: ViewScanner scanner;
+ * ---------------------------
+ * The constructor initializes a new scanner object.  The scanner
+ * starts empty, with no input to scan.
+ */
+	ViewScanner();
+
+/*
+ * Destructor: ~ViewScanner
+ * Usage: delete scannerPtr;
+ * -------------------------
+ * The destructor releases any file mapped by this scanner.  It
+ * does not free a buffer passed to setInput, which belongs to
+ * the client.
+ */
+	~ViewScanner();
+
+/*
+ * Method: setInput
+ * Usage: scanner.setInput(chars, length);
+ *        scanner.setInput(str);
+ * --------------------------------------
+ * This method configures this scanner to start extracting
+ * tokens from the given characters.  The scanner does not copy
+ * them, so the buffer or string must not change or be destroyed
+ * while the scanner or any token it has returned is in use.
+ */
+	void setInput(const char *chars, int length);
+	void setInput(const string & str);
+
+/*
+ * Method: mapFile
+ * Usage: if (scanner.mapFile(filename)) . . .
+ * -------------------------------------------
+ * This method maps the named file into memory and configures this
+ * scanner to extract tokens from its contents.  The mapping stays
+ * in place until the next call to setInput or mapFile, or until
+ * the scanner is destroyed.  The method returns false, leaving the
+ * scanner empty, if the file cannot be opened.
+ */
+	bool mapFile(string filename);
+
+/*
+ * Method: nextToken
+ * Usage: token = scanner.nextToken();
+ * -----------------------------------
+ * This method returns the next token from this scanner.  If
+ * nextToken is called when no tokens are available, it returns
+ * a token of length 0.
+ */
+	tokenViewT nextToken();
+
+/*
+ * Method: hasMoreTokens
+ * Usage: if (scanner.hasMoreTokens()) . . .
+ * ------------------------------------------
+ * This method returns true as long as there are additional
+ * tokens for this scanner to read.
+ */
+	bool hasMoreTokens();
+
+/*
+ * Method: saveToken
+ * Usage: scanner.saveToken(token);
+ * --------------------------------
+ * This method restores token into this scanner's input so that
+ * it will be read again on the next call to nextToken, as with
+ * Scanner::saveToken.  A token saved this way must be one that
+ * this scanner returned from its current input.
+ */
+	void saveToken(tokenViewT token);
+
+/*
+ * Methods: nextInteger, nextReal
+ * Usage: n = scanner.nextInteger();
+ *        d = scanner.nextReal();
+ * ----------------------------------
+ * These methods read the next number from this scanner and return
+ * its value, parsing the characters in place rather than first
+ * making a string.  A number may begin with a sign, which is read
+ * as part of the number whatever the setting of the number option.
+ * Each method raises an error if the next characters do not form a
+ * number of the right kind or if an integer is out of range.
+ */
+	int nextInteger();
+	double nextReal();
+
+/*
+ * Methods: setSpaceOption, getSpaceOption
+ * Usage: scanner.setSpaceOption(option);
+ *        option = scanner.getSpaceOption();
+ * ------------------------------------------
+ * These methods control whether this scanner ignores whitespace
+ * characters or returns them as tokens, as with Scanner.
+ */
+	enum spaceOptionT { PreserveSpaces, IgnoreSpaces };
+
+	void setSpaceOption(spaceOptionT option);
+	spaceOptionT getSpaceOption();
+
+/*
+ * Methods: setNumberOption, getNumberOption
+ * Usage: scanner.setNumberOption(option);
+ *        option = scanner.getNumberOption();
+ * -------------------------------------------
+ * These methods control how this scanner divides tokens that
+ * begin with a digit, as with Scanner.
+ */
+	enum numberOptionT {
+		ScanNumbersAsLetters,
+		ScanNumbersAsIntegers,
+		ScanNumbersAsReals
+	};
+
+	void setNumberOption(numberOptionT option);
+	numberOptionT getNumberOption();
+
+/*
+ * Methods: setStringOption, getStringOption
+ * Usage: scanner.setStringOption(option);
+ *        option = scanner.getStringOption();
+ * -------------------------------------------
+ * These methods control how this scanner treats double quotation
+ * marks, as with Scanner.  When quotes are scanned as strings, the
+ * token includes the quotation marks and any escape sequences
+ * exactly as they appear in the input, since translating them
+ * would require a copy.
+ */
+	enum stringOptionT { ScanQuotesAsPunctuation, ScanQuotesAsStrings };
+
+	void setStringOption(stringOptionT option);
+	stringOptionT getStringOption();
+
+private:
+
+#include "private/viewscanner.h"
+
+};
+
+#include "private/viewscanner.cpp"
+
+#endif
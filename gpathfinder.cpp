@@ -10,8 +10,14 @@
 #include "gpathfinder.h"
 #include "point.h"
 #include "vector.h"
+#include "queue.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
 
 /* Constants */
 
@@ -27,6 +33,8 @@ const double BUTTON_HEIGHT = 24;
 const double BUTTON_MARGIN = 6;
 const double BUTTON_SEP = 6;
 
+const double MOUSE_POLL_INTERVAL = 0.01;
+
 /* Structure for button data */
 
 struct buttonT {
@@ -36,15 +44,67 @@ struct buttonT {
 	ButtonCallbackBase *callback;
 };
 
+/* Structure for an edge drawn by DrawTriangles */
+
+struct edgeT {
+	double x1, y1, x2, y2;
+	int index;
+	bool operator<(const edgeT & other) const {
+		if (x1 != other.x1) return x1 < other.x1;
+		if (y1 != other.y1) return y1 < other.y1;
+		if (x2 != other.x2) return x2 < other.x2;
+		if (y2 != other.y2) return y2 < other.y2;
+		return index < other.index;
+	}
+	bool sameLine(const edgeT & other) const {
+		return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
+	}
+};
+
+/* Structure for timer data */
+
+struct timerT {
+	int id;
+	double interval, due;
+	bool canceled;
+	ButtonCallbackBase *callback;
+};
+
+/*
+ * Structure for an event waiting to be dispatched.  A NULL action
+ * stands for a click in the window at pt.  Posted actions belong to
+ * the queue and are deleted once they have run.
+ */
+
+struct eventT {
+	ButtonCallbackBase *action;
+	bool posted;
+	pointT pt;
+};
+
 /* Global data */
 
 static Vector<buttonT> buttons;
 ClickCallbackBase *clickHook = NULL;
+static Vector<timerT *> timers;
+static int nextTimerId = 1;
+static Queue<eventT> events;
+static std::mutex eventLock;
+static std::condition_variable eventSignal;
 
 /* Prototypes */
 
 void DrawBox(double x, double y, double width, double height);
 void FillBox(double x, double y, double width, double height);
+edgeT CreateEdge(double x1, double y1, double x2, double y2, int index);
+void TrackMousePress();
+void EnqueueEvent(eventT event);
+bool DequeueEvent(eventT & event);
+void DispatchEvent(eventT event);
+void DispatchTimers();
+void WaitForEvent();
+static double CurrentTime();
+static void SleepFor(double seconds);
 void DrawButton(buttonT & button);
 void DrawNormalButton(buttonT & button);
 void DrawHighlightedButton(buttonT & button);
@@ -127,6 +187,86 @@ void DrawPathfinderArc(pointT start, pointT end, string color) {
 	DrawLine(end.x - start.x, end.y - start.y);
 }
 
+/*
+ * Implementation notes: DrawTriangles
+ * -----------------------------------
+ * The triangles are drawn in two passes.  The first pass sorts the
+ * triangles into groups by fill color, keeping the order of the
+ * triangles within each group, and fills each group after a single
+ * call to SetPenColor.  The second pass collects the edges of the
+ * outlined triangles in a sorted copy, each written with its smaller
+ * endpoint first so that the two copies of a shared edge end up next
+ * to each other, and marks every copy after the first as a duplicate.
+ * It then draws the remaining edges in their original order, which
+ * goes around each triangle, so the pen only has to be moved where an
+ * edge does not start where the last one ended.  This relies on the
+ * client computing the corners that triangles share in the same way,
+ * so that they are exactly equal.
+ */
+
+void DrawTriangles(shadedTriangleT triangles[], int n, string outlineColor) {
+	Vector<string> colors;
+	Vector< Vector<int> > groups;
+	for (int i = 0; i < n; i++) {
+		int group = 0;
+		while (group < colors.size() && colors[group] != triangles[i].fillColor) {
+			group++;
+		}
+		if (group == colors.size()) {
+			colors.add(triangles[i].fillColor);
+			groups.add(Vector<int>());
+		}
+		groups[group].add(i);
+	}
+	for (int group = 0; group < groups.size(); group++) {
+		SetPenColor(colors[group]);
+		for (int k = 0; k < groups[group].size(); k++) {
+			shadedTriangleT & tp = triangles[groups[group][k]];
+			StartFilledRegion(1.0);
+			MovePen(tp.x[0], tp.y[0]);
+			for (int i = 0; i < 3; i++) {
+				DrawLine(tp.x[(i + 1) % 3] - tp.x[i], tp.y[(i + 1) % 3] - tp.y[i]);
+			}
+			EndFilledRegion();
+		}
+	}
+	Vector<int> outlined;
+	for (int t = 0; t < n; t++) {
+		if (triangles[t].outlined) outlined.add(t);
+	}
+	if (outlined.isEmpty()) return;
+	Vector<edgeT> sorted;
+	for (int k = 0; k < 3 * outlined.size(); k++) {
+		shadedTriangleT & tp = triangles[outlined[k / 3]];
+		int i = k % 3;
+		sorted.add(CreateEdge(tp.x[i], tp.y[i], tp.x[(i + 1) % 3], tp.y[(i + 1) % 3], k));
+	}
+	sort(&sorted[0], &sorted[0] + sorted.size());
+	Vector<bool> duplicate(sorted.size());
+	for (int k = 0; k < sorted.size(); k++) {
+		duplicate.add(false);
+	}
+	for (int k = 1; k < sorted.size(); k++) {
+		if (sorted[k].sameLine(sorted[k - 1])) duplicate[sorted[k].index] = true;
+	}
+	SetPenColor(outlineColor);
+	bool penPlaced = false;
+	double penX = 0, penY = 0;
+	for (int k = 0; k < duplicate.size(); k++) {
+		if (duplicate[k]) continue;
+		shadedTriangleT & tp = triangles[outlined[k / 3]];
+		int i = k % 3;
+		int j = (i + 1) % 3;
+		if (!penPlaced || penX != tp.x[i] || penY != tp.y[i]) {
+			MovePen(tp.x[i], tp.y[i]);
+			penPlaced = true;
+		}
+		DrawLine(tp.x[j] - tp.x[i], tp.y[j] - tp.y[i]);
+		penX = tp.x[j];
+		penY = tp.y[j];
+	}
+}
+
 /*
  * Implementation notes: UpdatePathfinderDisplay
  * ---------------------------------------------
@@ -197,59 +337,85 @@ void DefineClickListener(ClickCallbackBase *callback) {
 	clickHook = callback;
 }
 
+void RemoveClickListener() {
+	delete clickHook;
+	clickHook = NULL;
+}
+
+/*
+ * Implementation notes: SetTimer, CancelTimer
+ * -------------------------------------------
+ * The timers are kept in a vector that only the event loop's thread
+ * touches.  CancelTimer only marks a timer as canceled, because the
+ * timer may be canceled by its own timer function while that function
+ * is running; DispatchTimers deletes canceled timers once all the due
+ * timer functions have returned.
+ */
+
+int SetTimer(double seconds, void (*timerFn)()) {
+	return SetTimer(seconds, new ButtonCallbackBase(timerFn));
+}
+
+int SetTimer(double seconds, ButtonCallbackBase *callback) {
+	if (seconds <= 0) Error("SetTimer: The interval must be positive");
+	timerT *tp = new timerT;
+	tp->id = nextTimerId++;
+	tp->interval = seconds;
+	tp->due = CurrentTime() + seconds;
+	tp->canceled = false;
+	tp->callback = callback;
+	timers.add(tp);
+	return tp->id;
+}
+
+void CancelTimer(int id) {
+	for (int i = 0; i < timers.size(); i++) {
+		if (timers[i]->id == id) timers[i]->canceled = true;
+	}
+}
+
+/*
+ * Implementation notes: PostAction
+ * --------------------------------
+ * PostAction puts the action in the event queue, which is protected
+ * by a lock so that any thread can add to it, and signals the event
+ * loop in case it is asleep waiting for an event.
+ */
+
+void PostAction(void (*actionFn)()) {
+	PostAction(new ButtonCallbackBase(actionFn));
+}
+
+void PostAction(ButtonCallbackBase *callback) {
+	eventT event;
+	event.action = callback;
+	event.posted = true;
+	EnqueueEvent(event);
+}
+
 /*
  * Implementation notes: PathfinderEventLoop
  * -----------------------------------------
- * Even though the code for this function is long, its operation is
- * reasonably straightforward.  As soons as the mouse goes down, this
- * function monitors its position, waiting for the mouse to enter or
- * leave the area covered by a button object.  Entering a button
- * highlights it on the screen; leaving the button region removes the
- * highlight.  When the mouse button comes up, the code checks to see
- * whether the release is in a button and, if so, invokes its action
- * function.  If not, the code checks to see if the client has defined
- * a click action, in which case it calls the click function.
+ * The event loop handles one round of events each time through: a
+ * press of the mouse, which TrackMousePress follows until the button
+ * comes up and turns into an event; the timers that are due; and the
+ * events in the queue, which include the actions posted by other
+ * threads.  The loop then sleeps until an action is posted, the next
+ * timer is due, or MOUSE_POLL_INTERVAL seconds go by.  The graphics
+ * library only reports the mouse when asked, so the loop has to wake
+ * up now and then to look at it, but checking the mouse a hundred
+ * times a second takes almost no processor time.
  */
 
 void PathfinderEventLoop() {
 	while (true) {
-		WaitForMouseDown();
-		int downButtonIndex = FindButtonIndex(GetMouseX(), GetMouseY());
-		if (downButtonIndex != -1) {
-			buttons[downButtonIndex].highlighted = true;
-			DrawButton(buttons[downButtonIndex]);
-			UpdateDisplay();
-		}
-		bool isDown = true;
-		while (isDown) {
-			isDown = MouseButtonIsDown();
-			int index = FindButtonIndex(GetMouseX(), GetMouseY());
-			if (index != downButtonIndex) {
-				if (downButtonIndex != -1) {
-					buttons[downButtonIndex].highlighted = false;
-					DrawButton(buttons[downButtonIndex]);
-				}
-				if (index != -1 && isDown) {
-					buttons[index].highlighted = true;
-					DrawButton(buttons[index]);
-				}
-				downButtonIndex = index;
-				UpdateDisplay();
-			}
-		}
-		if (downButtonIndex != -1) {
-			buttons[downButtonIndex].highlighted = false;
-			DrawButton(buttons[downButtonIndex]);
-			UpdateDisplay();
-			buttons[downButtonIndex].callback->apply();
-		} else {
-			pointT pt;
-			pt.x = int(GetMouseX());
-			pt.y = int(GetMouseY());
-			if (pt.y < WINDOW_HEIGHT && clickHook != NULL) {
-				clickHook->apply(pt);
-			}
+		if (MouseButtonIsDown()) TrackMousePress();
+		DispatchTimers();
+		eventT event;
+		while (DequeueEvent(event)) {
+			DispatchEvent(event);
 		}
+		WaitForEvent();
 	}
 }
 
@@ -258,12 +424,17 @@ void PathfinderEventLoop() {
  * -----------------------------------
  * GetMouseClick waits for the mouse button to go down and then up again,
  * at which point the function returns the mouse position at the time of
- * release.
+ * release.  It checks the mouse every MOUSE_POLL_INTERVAL seconds and
+ * sleeps in between.
  */
 
 pointT GetMouseClick() {
-	WaitForMouseDown();
-	WaitForMouseUp();
+	while (!MouseButtonIsDown()) {
+		SleepFor(MOUSE_POLL_INTERVAL);
+	}
+	while (MouseButtonIsDown()) {
+		SleepFor(MOUSE_POLL_INTERVAL);
+	}
 	pointT pt;
 	pt.x = int(GetMouseX());
 	pt.y = int(GetMouseY());
@@ -272,6 +443,152 @@ pointT GetMouseClick() {
 
 /* Helper functions */
 
+/*
+ * Implementation notes: TrackMousePress
+ * -------------------------------------
+ * Even though the code for this function is long, its operation is
+ * reasonably straightforward.  While the mouse is down, this
+ * function monitors its position, waiting for the mouse to enter or
+ * leave the area covered by a button object.  Entering a button
+ * highlights it on the screen; leaving the button region removes the
+ * highlight.  When the mouse button comes up, the code checks to see
+ * whether the release is in a button and, if so, queues its action
+ * function.  If not, the code queues a click, which goes to the
+ * click listener if the client has defined one by the time the click
+ * is dispatched.
+ */
+
+void TrackMousePress() {
+	int downButtonIndex = FindButtonIndex(GetMouseX(), GetMouseY());
+	if (downButtonIndex != -1) {
+		buttons[downButtonIndex].highlighted = true;
+		DrawButton(buttons[downButtonIndex]);
+		UpdateDisplay();
+	}
+	bool isDown = true;
+	while (isDown) {
+		SleepFor(MOUSE_POLL_INTERVAL);
+		isDown = MouseButtonIsDown();
+		int index = FindButtonIndex(GetMouseX(), GetMouseY());
+		if (index != downButtonIndex) {
+			if (downButtonIndex != -1) {
+				buttons[downButtonIndex].highlighted = false;
+				DrawButton(buttons[downButtonIndex]);
+			}
+			if (index != -1 && isDown) {
+				buttons[index].highlighted = true;
+				DrawButton(buttons[index]);
+			}
+			downButtonIndex = index;
+			UpdateDisplay();
+		}
+	}
+	eventT event;
+	event.posted = false;
+	if (downButtonIndex != -1) {
+		buttons[downButtonIndex].highlighted = false;
+		DrawButton(buttons[downButtonIndex]);
+		UpdateDisplay();
+		event.action = buttons[downButtonIndex].callback;
+		EnqueueEvent(event);
+	} else {
+		event.action = NULL;
+		event.pt.x = int(GetMouseX());
+		event.pt.y = int(GetMouseY());
+		if (event.pt.y < WINDOW_HEIGHT) EnqueueEvent(event);
+	}
+}
+
+/*
+ * Implementation notes: EnqueueEvent, DequeueEvent, DispatchEvent
+ * ---------------------------------------------------------------
+ * These functions manage the event queue.  EnqueueEvent and
+ * DequeueEvent hold the lock only while they change the queue, so
+ * that other threads can post actions while an event is dispatched.
+ */
+
+void EnqueueEvent(eventT event) {
+	{
+		std::lock_guard<std::mutex> guard(eventLock);
+		events.enqueue(event);
+	}
+	eventSignal.notify_one();
+}
+
+bool DequeueEvent(eventT & event) {
+	std::lock_guard<std::mutex> guard(eventLock);
+	if (events.isEmpty()) return false;
+	event = events.dequeue();
+	return true;
+}
+
+void DispatchEvent(eventT event) {
+	if (event.action == NULL) {
+		if (clickHook != NULL) clickHook->apply(event.pt);
+	} else {
+		event.action->apply();
+		if (event.posted) delete event.action;
+	}
+}
+
+/*
+ * Implementation notes: DispatchTimers, WaitForEvent
+ * --------------------------------------------------
+ * DispatchTimers calls the function of every timer that is due and
+ * then deletes the timers that have been canceled.  WaitForEvent
+ * sleeps on the condition variable that PostAction signals, for no
+ * longer than MOUSE_POLL_INTERVAL or the time until the next timer is
+ * due.  It returns early if an action is posted, and a spurious
+ * wakeup does no harm, since the event loop simply looks again.
+ */
+
+void DispatchTimers() {
+	double now = CurrentTime();
+	for (int i = 0; i < timers.size(); i++) {
+		timerT *tp = timers[i];
+		if (tp->canceled || tp->due > now) continue;
+		tp->due += tp->interval;
+		if (tp->due <= now) tp->due = now + tp->interval;
+		tp->callback->apply();
+	}
+	for (int i = timers.size() - 1; i >= 0; i--) {
+		if (timers[i]->canceled) {
+			delete timers[i]->callback;
+			delete timers[i];
+			timers.removeAt(i);
+		}
+	}
+}
+
+void WaitForEvent() {
+	double timeout = MOUSE_POLL_INTERVAL;
+	double now = CurrentTime();
+	for (int i = 0; i < timers.size(); i++) {
+		if (!timers[i]->canceled) timeout = min(timeout, timers[i]->due - now);
+	}
+	if (timeout <= 0) return;
+	std::unique_lock<std::mutex> lock(eventLock);
+	if (events.isEmpty()) {
+		eventSignal.wait_for(lock, std::chrono::duration<double>(timeout));
+	}
+}
+
+/*
+ * Implementation notes: CurrentTime, SleepFor
+ * -------------------------------------------
+ * CurrentTime returns the time in seconds from an arbitrary starting
+ * point, and SleepFor gives up the processor for the given number of
+ * seconds.
+ */
+
+static double CurrentTime() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void SleepFor(double seconds) {
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
 /*
  * Implementation notes: DrawBox, FillBox
  * --------------------------------------
@@ -295,6 +612,28 @@ void FillBox(double x, double y, double width, double height) {
 	EndFilledRegion();
 }
 
+/*
+ * Implementation notes: CreateEdge
+ * --------------------------------
+ * This function returns the edge between two points, written so that
+ * the endpoint that comes first in the order used by edgeT is first,
+ * and tagged with the given index.
+ */
+
+edgeT CreateEdge(double x1, double y1, double x2, double y2, int index) {
+	edgeT edge;
+	if (x2 < x1 || (x2 == x1 && y2 < y1)) {
+		swap(x1, x2);
+		swap(y1, y2);
+	}
+	edge.x1 = x1;
+	edge.y1 = y1;
+	edge.x2 = x2;
+	edge.y2 = y2;
+	edge.index = index;
+	return edge;
+}
+
 /*
  * Implementation notes: DrawButton and its subsidiary functions
  * -------------------------------------------------------------
@@ -93,6 +93,35 @@ void DrawPathfinderNode(pointT center, string color, string label = "");
 
 void DrawPathfinderArc(pointT start, pointT end, string color);
 
+/*
+ * Type: shadedTriangleT
+ * ---------------------
+ * A triangle to be drawn by DrawTriangles, given by the screen
+ * coordinates of its corners, the color to fill it with, and whether
+ * it should also be outlined.
+ */
+
+struct shadedTriangleT {
+	double x[3], y[3];
+	string fillColor;
+	bool outlined;
+};
+
+/*
+ * Function: DrawTriangles
+ * Usage: DrawTriangles(triangles, n, outlineColor);
+ * -------------------------------------------------
+ * Draws the first n triangles in the array, filling each in its own
+ * color and then outlining the ones whose outlined field is true in
+ * outlineColor.  The result is the same as drawing the triangles one
+ * at a time as long as they do not overlap, but it takes far fewer
+ * calls to the graphics library: the fill color changes only once for
+ * each different color, and an edge shared by two outlined triangles
+ * is drawn only once.  The pen color is left set to outlineColor.
+ */
+
+void DrawTriangles(shadedTriangleT triangles[], int n, string outlineColor);
+
 /*
  * Function: UpdatePathfinderDisplay
  * Usage: UpdatePathfinderDisplay();
@@ -159,6 +188,60 @@ template <typename ClientDataType>
 void DefineClickListener(void (*actionFn)(pointT pt, ClientDataType & data),
                          ClientDataType & data);
 
+/*
+ * Function: RemoveClickListener
+ * Usage: RemoveClickListener();
+ * -----------------------------
+ * Removes the click listener, if there is one, so that clicks in the
+ * window are ignored until DefineClickListener is called again.  This
+ * function must not be called from inside the click listener itself.
+ */
+
+void RemoveClickListener();
+
+/*
+ * Function: SetTimer
+ * Usage: id = SetTimer(seconds, timerFn);
+ *        id = SetTimer(seconds, timerFn, data);
+ * ---------------------------------------------
+ * Starts a timer that calls timerFn() or timerFn(data) from
+ * PathfinderEventLoop every time the specified number of seconds goes
+ * by, until the timer is stopped by passing the id that SetTimer
+ * returns to CancelTimer.  If the program falls behind, the timer does
+ * not try to catch up by calling timerFn several times in a row; it
+ * simply waits the full interval again.  A timer function can cancel
+ * its own timer.
+ */
+
+int SetTimer(double seconds, void (*timerFn)());
+
+template <typename ClientDataType>
+int SetTimer(double seconds,
+             void (*timerFn)(ClientDataType & data),
+             ClientDataType & data);
+
+void CancelTimer(int id);
+
+/*
+ * Function: PostAction
+ * Usage: PostAction(actionFn);
+ *        PostAction(actionFn, data);
+ * ----------------------------------
+ * Asks PathfinderEventLoop to call actionFn() or actionFn(data) as
+ * soon as it has finished with the current event.  Unlike the other
+ * functions in this interface, PostAction may be called from any
+ * thread, which makes it the way for a background thread to hand its
+ * results to the program: the action function always runs on the
+ * thread that called PathfinderEventLoop.  Actions run in the order in
+ * which they were posted.
+ */
+
+void PostAction(void (*actionFn)());
+
+template <typename ClientDataType>
+void PostAction(void (*actionFn)(ClientDataType & data),
+                ClientDataType & data);
+
 /*
  * Function: PathfinderEventLoop
  * Usage: PathfinderEventLoop();
@@ -167,7 +250,10 @@ void DefineClickListener(void (*actionFn)(pointT pt, ClientDataType & data),
  * on a button and calls the action function associated with that
  * button.  Moreover, if the client has registered a click listener,
  * PathfinderEventLoop will call that listener whenever the mouse is
- * clicked inside the window.
+ * clicked inside the window.  The loop also calls the functions of
+ * timers that are due and of actions posted with PostAction.
+ * Between events, the loop sleeps rather than keeping the processor
+ * busy.
  *
  * Note that PathfinderEventLoop never returns, so programs that need
  * to exit on user command need to call the exit() function in the
@@ -1,8 +1,8 @@
 /*
  * File: gpathfinderimpl.cpp
  * -------------------------
- * This function implements the template functions AddButton
- * and AddClickListener.  C++ requires that this code be
+ * This function implements the template functions AddButton,
+ * AddClickListener, SetTimer, and PostAction.  C++ requires that this code be
  * available at the time the interface is read, but clients
  * are not expected to look at this code.
  */
@@ -115,10 +115,12 @@ void ClickCallback<ClientDataType>::apply(pointT pt) {
 
 void AddButton(string name, ButtonCallbackBase *callback);
 void DefineClickListener(ClickCallbackBase *callback);
+int SetTimer(double seconds, ButtonCallbackBase *callback);
+void PostAction(ButtonCallbackBase *callback);
 
 /*
- * Implementation notes: AddButton, DefineClickListener
- * ----------------------------------------------------
+ * Implementation notes: AddButton, DefineClickListener, SetTimer, PostAction
+ * --------------------------------------------------------------------------
  * These template functions create the appropriate callback
  * structure and then call a non-template function in
  * gpathfinder.cpp that works with that with the base class
@@ -139,5 +141,18 @@ void DefineClickListener(void (*clickFn)(pointT pt, ClientDataType & data),
 	DefineClickListener(new ClickCallback<ClientDataType>(clickFn, &data));
 }
 
+template <typename ClientDataType>
+int SetTimer(double seconds,
+             void (*timerFn)(ClientDataType & data),
+             ClientDataType & data) {
+	return SetTimer(seconds, new ButtonCallback<ClientDataType>(timerFn, &data));
+}
+
+template <typename ClientDataType>
+void PostAction(void (*actionFn)(ClientDataType & data),
+                ClientDataType & data) {
+	PostAction(new ButtonCallback<ClientDataType>(actionFn, &data));
+}
+
 #endif
 
@@ -160,10 +160,25 @@
 #include "gpathfinder.h"
 #include <iostream>
 #include "vector.h"
-#include "scanner.h"
+#include "hashmap.h"
+#include "grid.h"
+#include "viewscanner.h"
+#include "strutils.h"
+#include "instrument.h"
+#include "trace.h"
+#include "offscreengraphics.h"
 #include "simpio.h" 
 #include "extgraph.h"
 #include "graphics.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <condition_variable>
+#include <csignal>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 
 
@@ -177,6 +192,19 @@ const double CONTROL_STRIP_HEIGHT = 40;
 const int CREATE_PUZZLE_X_MARGIN = 50;
 const int CREATE_PUZZLE_Y_MARGIN = 50;
 const int CREATE_PUZZLE_STEP = 30;
+const double FALL_DURATION = 0.4;
+const double ANIMATION_FRAME_RATE = 60;
+const int SCENE_BUCKET_SIZE = 32;
+const int SVG_SIZE = 1000;
+const int SVG_BUFFER_SIZE = 1 << 16;
+const int SVG_WAVE_COLORS = 12;
+const int VIEW_SHARDS_PER_CELL = 4;
+const double VIEW_ZOOM_STEP = 2;
+const double VIEW_MAX_ZOOM = 1000;
+const double VIEW_MERGE_SIZE = 16;
+const double VIEW_OUTLINE_SIZE = 4;
+const double VIEW_LABEL_SIZE = 24;
+const double SOLVE_PROGRESS_INTERVAL = 0.1;
 
 
 
@@ -191,6 +219,14 @@ struct lineT {
 	int x1, x2, y1, y2;
 };
 
+/*
+ * Two lineT's are equal if they have the same endpoints in the same order, which is what a HashMap keyed by lines
+ * needs. Use compareLines to ignore the order of the endpoints.
+ */
+inline bool operator==(const lineT & a, const lineT & b) {
+	return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
 /*
  * triangleT represents a numbered triangle defined by three lineT's.
  */
@@ -206,6 +242,114 @@ struct puzzleBorderT {
 	int minX, minY, maxX, maxY;
 };
 
+/*
+ * rectT represents a rectangle in window coordinates by its upper left corner and its size.
+ */
+struct rectT {
+	double x, y, width, height;
+};
+
+/*
+ * viewTransformT maps puzzle coordinates to window coordinates: the point (x, y) of the puzzle appears in the
+ * window at (x*scale + xOffset, yOffset - y*scale). bounds is the rectangle the puzzle border covers in the window.
+ */
+struct viewTransformT {
+	double scale, xOffset, yOffset;
+	rectT bounds;
+};
+
+/*
+ * shardT represents a triangle as it appears in the window: its corners in window coordinates, its colors, and
+ * the rectangle that bounds everything drawing it can touch.
+ */
+struct shardT {
+	double x[3], y[3];
+	string fillColor, outlineColor;
+	rectT bounds;
+};
+
+/*
+ * sceneT retains the shards placed in the window so far, so that any part of the window can be repainted
+ * without redrawing the whole puzzle. The window is divided into squares of SCENE_BUCKET_SIZE pixels, and
+ * buckets lists, for each square, the indices of the shards whose bounds overlap it. paintStamps and
+ * currentStamp keep a shard that overlaps several squares from being painted more than once per repaint.
+ */
+struct sceneT {
+	Vector<shardT> shards;
+	Grid<Vector<int> > buckets;
+	Vector<int> paintStamps;
+	int currentStamp;
+};
+
+
+
+/*
+ * exportFormatT lists the ways the frames of an exported animation can be written: as numbered PNG or PPM files,
+ * or as a stream of raw RGBA frames piped to another program.
+ */
+enum exportFormatT { PNGFrames, PPMFrames, RawStream };
+
+/*
+ * exportJobT holds what the threads exporting an animation share: the solution and how to draw it, the next
+ * triangle waiting to be rendered, and, for a raw stream, the pipe and the number of the next triangle whose
+ * frames may be written to it.
+ */
+struct exportJobT {
+	Vector<triangleT> *triangles;
+	exportFormatT format;
+	string target;
+	viewTransformT transform;
+	Vector<shardT> placedShards;
+	string highlightColor;
+	int framesPerTriangle;
+	std::atomic<int> nextTriangle;
+	std::atomic<bool> failed;
+	string errorMessage;
+	FILE *pipe;
+	int nextToWrite;
+	std::mutex lock;
+	std::condition_variable turn;
+};
+
+/*
+ * solveJobT holds what a solve running on a background thread shares with the event loop: a copy of the puzzle,
+ * the solution or the error message once the solve is over, and the pause to animate the solution with. The worker
+ * calls progressFn each time it places a triangle, and stops at the next triangle once canceled becomes true. The
+ * default progressFn, recordSolveProgress, saves its arguments in nPlaced and nBoundaryLines for a timer to show.
+ */
+struct solveJobT {
+	Vector<triangleT> *triangles;
+	Vector<triangleT> puzzle;
+	Vector<triangleT> solution;
+	double pause;
+	void (*progressFn)(solveJobT & job, int nPlaced, int nBoundaryLines);
+	std::atomic<bool> canceled;
+	std::atomic<int> nPlaced, nBoundaryLines;
+	bool failed;
+	string errorMessage;
+	int timer;
+	std::thread worker;
+};
+
+/*
+ * viewerT holds the state of the puzzle viewer. The solved puzzle is divided into square cells of cellSize units,
+ * about VIEW_SHARDS_PER_CELL triangles each, and cells lists, for each cell, the positions in solution of the
+ * triangles whose bounds overlap it; row 0 is the bottom row of the puzzle. The view is given by the puzzle
+ * coordinates that appear in the center of the window and by the zoom in pixels per unit, which can go no lower
+ * than fitZoom, the zoom at which the whole puzzle fits. paintStamps and currentStamp keep a triangle that
+ * overlaps several cells from being drawn more than once per redraw.
+ */
+struct viewerT {
+	Vector<triangleT> solution;
+	puzzleBorderT puzzleBorder;
+	Grid<Vector<int> > cells;
+	double cellSize;
+	Vector<int> paintStamps;
+	int currentStamp;
+	double centerX, centerY;
+	double zoom, fitZoom;
+};
+
 
 
 /*****************************/
@@ -222,29 +366,66 @@ void clearAction(Vector<triangleT> & triangles);
 void saveAction(Vector<triangleT> & triangles);
 void solveAction(Vector<triangleT> & triangles);
 void solveStepByStepAction(Vector<triangleT> & triangles);
+void cancelSolveAction(solveJobT & job);
+void quitSolveAction(solveJobT & job);
+void exportAnimationAction(Vector<triangleT> & triangles);
+void exportDrawingAction(Vector<triangleT> & triangles);
+void exploreAction(Vector<triangleT> & triangles);
+void zoomInAction(viewerT & viewer);
+void zoomOutAction(viewerT & viewer);
+void fitViewAction(viewerT & viewer);
+void recenterViewAction(pointT pt, viewerT & viewer);
+void addAnalyzeModeButtons(Vector<triangleT> & triangles);
+void removeModeButtons();
+void startSolve(Vector<triangleT> & triangles, double pause);
+void solveWorker(solveJobT & job);
+void recordSolveProgress(solveJobT & job, int nPlaced, int nBoundaryLines);
+void showSolveProgress(solveJobT & job);
+void finishSolve(solveJobT & job);
 void drawPuzzle(Vector<triangleT> & triangles, double pause, string highlightColor, string fillColor, string outlineColor);
 void fillBackground(string color);
 void drawGrid();
 pointT getGridClick(int xMargin, int yMargin, int step);
-void animateFallingTriangle(triangleT & triangle, double scaleFactor, double xMargin, double yMargin, double height, double density = 1.0);
-void drawFilledTriangle(triangleT & triangle, double scaleFactor, double xMargin, double yMargin, double height, double density = 1.0);
-void drawFilledTriangle(triangleT & triangle, puzzleBorderT & puzzleBorder);
-void drawFilledTriangle(triangleT & triangle);
-void drawTriangle(triangleT & triangle, double scaleFactor, double xMargin, double yMargin, double height);
-void drawTriangle(triangleT & triangle, puzzleBorderT & puzzleBorder);
-void drawTriangle(triangleT & triangle);
-void drawLine(lineT & line, double scaleFactor, double xMargin, double yMargin, double height);
+void animateFallingTriangle(sceneT & scene, triangleT & triangle, viewTransformT & transform, string color, double speed = 1.0);
+double currentTime();
+bool getExportFormat(string target, exportFormatT & format);
+string exportFileName(string target, int frameNumber);
+int exportAnimation(Vector<triangleT> & triangles, string target, string highlightColor, string fillColor, string outlineColor);
+void exportWorker(exportJobT & job);
+void exportFrame(exportJobT & job, OffscreenGraphics & canvas, int frameNumber, string & frames);
+void writeFramesInTurn(exportJobT & job, int triangleCounter, string & frames);
+void initScene(sceneT & scene);
+shardT createShard(triangleT & triangle, viewTransformT & transform, string fillColor, string outlineColor = "");
+Vector<shardT> createShards(Vector<triangleT> & triangles, viewTransformT & transform, string fillColor, string outlineColor);
+void setShardBounds(shardT & shard);
+void addShardToScene(sceneT & scene, shardT & shard, OffscreenGraphics *canvas = NULL);
+void repaintSceneRect(sceneT & scene, rectT rect, OffscreenGraphics *canvas = NULL);
+void drawShard(shardT & shard, OffscreenGraphics *canvas = NULL);
+void drawShards(Vector<shardT> & shards, Vector<int> & indices, OffscreenGraphics *canvas = NULL);
+void initViewer(viewerT & viewer, Vector<triangleT> & solution);
+void fitView(viewerT & viewer);
+void drawView(viewerT & viewer);
+void drawMergedCells(viewerT & viewer, viewTransformT & transform, int minRow, int maxRow, int minCol, int maxCol);
+void drawShardLabel(shardT & shard, int num);
+viewTransformT createTransform(puzzleBorderT & puzzleBorder, double scale, double xOffset, double yOffset);
+viewTransformT fitTransform(puzzleBorderT & puzzleBorder);
+viewTransformT createPuzzleTransform();
+void transformVertices(viewTransformT & transform, double x[], double y[], int n);
+void drawFilledTriangle(triangleT & triangle, viewTransformT & transform, double density = 1.0);
+void drawTriangle(triangleT & triangle, viewTransformT & transform);
+void drawLine(lineT & line, viewTransformT & transform);
 void drawPoint(pointT point, string color);
 void drawTriangleNum(Vector<triangleT> triangles, int triangleCounter);
 void saveFile(ofstream & outfile, Vector<triangleT> & triangles);
 void outfilePutInt(ofstream & outfile, int num);
-void readFile(ifstream & infile, Vector<triangleT> & triangles);
+void readFile(string fileName, Vector<triangleT> & triangles);
 string getInputFileName(ifstream & infile);
 string getOutputFileName(ofstream & outfile);
 triangleT createTriangle(Vector<pointT> points);
 lineT createLine(pointT a, pointT b);
-Vector<triangleT> solve(Vector<triangleT> triangles);
-void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT & puzzleBorder);
+Vector<triangleT> solve(Vector<triangleT> triangles, solveJobT *job = NULL);
+void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT & puzzleBorder, solveJobT *job);
+bool placeNextTriangle(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT & puzzleBorder);
 puzzleBorderT findPuzzleBorder(Vector<triangleT> triangles);
 void findStartingTriangles(Vector<triangleT> & triangles, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT puzzleBorder);
 bool compareLines(lineT a, lineT b);
@@ -255,6 +436,12 @@ bool doesNotBlock(Vector<lineT> & boundaryLines, triangleT triangle, lineT line,
 void defineObstructedLine(triangleT triangle, lineT & obstructedLine);
 bool obstructedLineIsBoundaryLine(Vector<lineT> & boundaryLines, lineT & obstructedLine);
 void removeDuplicateBoundaryLines(Vector<lineT> & boundaryLines);
+Vector<int> findWaves(Vector<triangleT> & solution);
+lineT orderedLine(lineT line);
+void writeSVG(ofstream & outfile, Vector<triangleT> & solution);
+void svgPutInt(string & buffer, int num);
+void svgPutReal(string & buffer, double num);
+void svgFlush(ofstream & outfile, string & buffer, int limit);
 string trianglesToString(Vector<triangleT> triangles);
 void printTriangle(triangleT triangle);
 void printLine(lineT line, int num);
@@ -314,20 +501,15 @@ void quitAction(Vector<triangleT> & triangles) {
  */
 void loadSavedPuzzleAction(Vector<triangleT> & triangles) {
 	fillBackground("white");
-	RemoveButton("Analyze Mode");
-	RemoveButton("Solve");
-	RemoveButton("Solve Step-by-Step");
-	RemoveButton("Create Puzzle Mode");
-	RemoveButton("Draw Triangle");
-	RemoveButton("Clear");
-	RemoveButton("Save");
+	removeModeButtons();
 	AddButton("Create Puzzle Mode", createPuzzleModeAction, triangles);
 	AddButton("Analyze Mode", analyzeModeAction, triangles);
 	triangles.clear();
 	ifstream infile;
 	string fileName = getInputFileName(infile);
 	if (fileName.empty()) return;
-    readFile(infile, triangles);
+	infile.close();
+    readFile(fileName, triangles);
 	drawPuzzle(triangles, -1, "green", "blue", "black");
 }
 
@@ -336,10 +518,7 @@ void loadSavedPuzzleAction(Vector<triangleT> & triangles) {
  */
 void createPuzzleModeAction(Vector<triangleT> & triangles) {
 	fillBackground("white");
-	RemoveButton("Create Puzzle Mode");
-	RemoveButton("Analyze Mode");
-	RemoveButton("Solve");
-	RemoveButton("Solve Step-by-Step");
+	removeModeButtons();
 	AddButton("Analyze Mode", analyzeModeAction, triangles);
 	AddButton("Draw Triangle", drawTriangleAction, triangles);
 	AddButton("Clear", clearAction, triangles);
@@ -362,17 +541,15 @@ void createPuzzleModeAction(Vector<triangleT> & triangles) {
  */
 void analyzeModeAction(Vector<triangleT> & triangles) {
 	if (triangles.isEmpty()) return;
-	RemoveButton("Create Puzzle Mode");
-	RemoveButton("Analyze Mode");
-	RemoveButton("Draw Triangle");
-	RemoveButton("Clear");
-	RemoveButton("Save");
-	AddButton("Create Puzzle Mode", createPuzzleModeAction, triangles);
-	AddButton("Solve", solveAction, triangles);
-	AddButton("Solve Step-by-Step", solveStepByStepAction, triangles);
+	removeModeButtons();
+	addAnalyzeModeButtons(triangles);
 	cout << "\nClick \"SOLVE\" to watch an animation of the puzzle solution." << endl
 		<< "Click \"SOLVE STEP-BY-STEP\" to walk through the solution at your own pace," << endl
-		<< "   separating each step with a click." << endl;
+		<< "   separating each step with a click." << endl
+		<< "Click \"CANCEL\" while the puzzle is being solved to stop solving it." << endl
+		<< "Click \"EXPORT ANIMATION\" to save every frame of the animation as images." << endl
+		<< "Click \"EXPORT DRAWING\" to save the solved puzzle as an SVG assembly sheet." << endl
+		<< "Click \"EXPLORE\" to zoom in on the solved puzzle, however many triangles it has." << endl;
 }
 
 /******************************/
@@ -383,6 +560,7 @@ void analyzeModeAction(Vector<triangleT> & triangles) {
  * Enables the user to define a triangle by clicking three points on a grid.
  */
 void drawTriangleAction(Vector<triangleT> & triangles) {
+	static viewTransformT transform = createPuzzleTransform();
 	cout << "\nClick three points in the grid to define a triangle's vertices." << endl;
 	Vector<pointT> points;
 	for (int vertex = 0; vertex < 3; vertex++) {
@@ -393,12 +571,12 @@ void drawTriangleAction(Vector<triangleT> & triangles) {
 	newTriangle.num = triangles.size();
 	triangles.add(newTriangle);
 	SetPenColor("green");
-	drawFilledTriangle(newTriangle);
+	drawFilledTriangle(newTriangle, transform);
 	Pause(0.5);
 	SetPenColor("blue");
-	drawFilledTriangle(newTriangle);
+	drawFilledTriangle(newTriangle, transform);
 	SetPenColor("black");
-	drawTriangle(newTriangle);
+	drawTriangle(newTriangle, transform);
 	for (int vertex = 0; vertex < 3; vertex++)
 		drawPoint(points[vertex], "black");
 }
@@ -430,27 +608,170 @@ void saveAction(Vector<triangleT> & triangles) {
 /************************/
 
 /*
- * Animates a solution to the puzzle.
+ * Animates a solution to the puzzle once it has been solved in the background.
  */
 void solveAction(Vector<triangleT> & triangles) {
 	if (triangles.isEmpty()) return;
-	fillBackground("white");
-	Vector<lineT> boundaryLines;
-	Vector<triangleT> solution = solve(triangles);
-	printSolution(solution);
-	drawPuzzle(solution, 0.4, "green", "blue", "black");
+	startSolve(triangles, 0.4);
 }
 
 /*
- * Enables the user to walk through the solution step-by-step, separated by clicks.
+ * Enables the user to walk through the solution step-by-step, separated by clicks, once it has been solved in
+ * the background.
  */
 void solveStepByStepAction(Vector<triangleT> & triangles) {
 	if (triangles.isEmpty()) return;
-	fillBackground("white");
-	Vector<lineT> boundaryLines;
-	Vector<triangleT> solution = solve(triangles);
-	printSolution(solution);
-	drawPuzzle(solution, 0, "green", "blue", "black");
+	startSolve(triangles, 0);
+}
+
+/*
+ * Stops the solve running in the background. The worker notices at the next triangle, and finishSolve restores
+ * the buttons.
+ */
+void cancelSolveAction(solveJobT & job) {
+	job.canceled = true;
+}
+
+/*
+ * Quits the program while a solve is running in the background. The worker is stopped and joined first, since
+ * ending the program while it still runs would destroy the job under it.
+ */
+void quitSolveAction(solveJobT & job) {
+	job.canceled = true;
+	if (job.worker.joinable()) job.worker.join();
+	CancelTimer(job.timer);
+	quitAction(*job.triangles);
+}
+
+/*
+ * Renders every frame of the solution animation offscreen and saves the frames to numbered image files or pipes
+ * them to a command, such as a video encoder.
+ */
+void exportAnimationAction(Vector<triangleT> & triangles) {
+	if (triangles.isEmpty()) return;
+	cout << "\nType a file name ending in .png or .ppm to save the frames as numbered images," << endl
+		<< "or | followed by a command to pipe raw " << int(WINDOW_WIDTH) << "x" << int(WINDOW_HEIGHT)
+		<< " RGBA frames to it: ";
+	string target;
+	exportFormatT format;
+	while (true) {
+		target = GetLine();
+		if (target.empty()) return;
+		if (!getExportFormat(target, format)) {
+			cout << "Invalid name! Try again, please: ";
+		} else if (format != RawStream && !ofstream(exportFileName(target, 0).c_str())) {
+			cout << "Invalid file! Try again, please: ";
+		} else {
+			break;
+		}
+	}
+	try {
+		Vector<triangleT> solution = solve(triangles);
+		double startTime = currentTime();
+		int nFrames = exportAnimation(solution, target, "green", "blue", "black");
+		cout << "Exported " << nFrames << " frames at " << ANIMATION_FRAME_RATE << " frames per second in "
+			<< currentTime() - startTime << " seconds." << endl;
+	} catch (ErrorException & ex) {
+		cout << "\n" << ex.getMessage() << endl;
+	}
+}
+
+/*
+ * Saves the solved puzzle as an SVG drawing, with each triangle numbered in the order it is dropped and colored
+ * by its wave.
+ */
+void exportDrawingAction(Vector<triangleT> & triangles) {
+	if (triangles.isEmpty()) return;
+	cout << "\nType the name of an SVG file in which to save the solved puzzle: ";
+	ofstream outfile;
+	string answer;
+	while (true) {
+		answer = GetLine();
+		if (answer.empty()) return;
+		outfile.open(answer.c_str());
+		if (!outfile.fail()) break;
+		outfile.clear();
+		cout << "Invalid file! Try again, please: ";
+	}
+	try {
+		Vector<triangleT> solution = solve(triangles);
+		writeSVG(outfile, solution);
+		outfile.close();
+		cout << "\nSaved!" << endl;
+	} catch (ErrorException & ex) {
+		outfile.close();
+		remove(answer.c_str());
+		cout << "\n" << ex.getMessage() << endl;
+	}
+}
+
+/*
+ * Shows the solved puzzle in a viewer that can zoom in on any part of it, with each triangle labeled with its
+ * number once it is large enough to hold one. The viewer stays responsive for puzzles with any number of
+ * triangles, because a redraw only touches the triangles in view.
+ */
+void exploreAction(Vector<triangleT> & triangles) {
+	if (triangles.isEmpty()) return;
+	static viewerT viewer;
+	Vector<triangleT> solution;
+	try {
+		solution = solve(triangles);
+	} catch (ErrorException & ex) {
+		cout << "\n" << ex.getMessage() << endl;
+		return;
+	}
+	initViewer(viewer, solution);
+	removeModeButtons();
+	AddButton("Analyze Mode", analyzeModeAction, triangles);
+	AddButton("Zoom In", zoomInAction, viewer);
+	AddButton("Zoom Out", zoomOutAction, viewer);
+	AddButton("Fit", fitViewAction, viewer);
+	DefineClickListener(recenterViewAction, viewer);
+	cout << "\nClick anywhere in the puzzle to move that point to the center." << endl
+		<< "Click \"ZOOM IN\" or \"ZOOM OUT\" to change the magnification, and \"FIT\" to see the whole puzzle." << endl
+		<< "Click \"ANALYZE MODE\" to go back." << endl;
+	drawView(viewer);
+}
+
+/*******************/
+/* Explore Buttons */
+/*******************/
+
+/*
+ * Doubles the magnification of the view, up to VIEW_MAX_ZOOM pixels per unit.
+ */
+void zoomInAction(viewerT & viewer) {
+	viewer.zoom = min(viewer.zoom * VIEW_ZOOM_STEP, max(VIEW_MAX_ZOOM, viewer.fitZoom));
+	drawView(viewer);
+}
+
+/*
+ * Halves the magnification of the view, but never so far that the puzzle is smaller than the window.
+ */
+void zoomOutAction(viewerT & viewer) {
+	viewer.zoom = max(viewer.zoom / VIEW_ZOOM_STEP, viewer.fitZoom);
+	drawView(viewer);
+}
+
+/*
+ * Returns to the view of the whole puzzle.
+ */
+void fitViewAction(viewerT & viewer) {
+	fitView(viewer);
+	drawView(viewer);
+}
+
+/*
+ * Moves the clicked point to the center of the window, keeping the center of the view inside the puzzle.
+ */
+void recenterViewAction(pointT pt, viewerT & viewer) {
+	double viewHeight = WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT;
+	if (pt.y >= viewHeight) return;
+	viewer.centerX += (pt.x - WINDOW_WIDTH/2) / viewer.zoom;
+	viewer.centerY -= (pt.y - viewHeight/2) / viewer.zoom;
+	viewer.centerX = max(double(viewer.puzzleBorder.minX), min(double(viewer.puzzleBorder.maxX), viewer.centerX));
+	viewer.centerY = max(double(viewer.puzzleBorder.minY), min(double(viewer.puzzleBorder.maxY), viewer.centerY));
+	drawView(viewer);
 }
 
 
@@ -459,6 +780,142 @@ void solveStepByStepAction(Vector<triangleT> & triangles) {
 /*** HELPER FUNCTIONS ***/
 /************************/
 
+/***********/
+/* Buttons */
+/***********/
+
+/*
+ * Adds the buttons of the "Analyze Mode" after the ones already in the control strip.
+ */
+void addAnalyzeModeButtons(Vector<triangleT> & triangles) {
+	AddButton("Create Puzzle Mode", createPuzzleModeAction, triangles);
+	AddButton("Solve", solveAction, triangles);
+	AddButton("Solve Step-by-Step", solveStepByStepAction, triangles);
+	AddButton("Export Animation", exportAnimationAction, triangles);
+	AddButton("Export Drawing", exportDrawingAction, triangles);
+	AddButton("Explore", exploreAction, triangles);
+}
+
+/*
+ * Removes the buttons of every mode, and the click listener of the viewer, leaving only "Quit" and "Load Saved
+ * Puzzle". Each action that switches modes calls this before adding the buttons of its own mode, so a new button
+ * only has to be listed here.
+ */
+void removeModeButtons() {
+	RemoveButton("Create Puzzle Mode");
+	RemoveButton("Analyze Mode");
+	RemoveButton("Draw Triangle");
+	RemoveButton("Clear");
+	RemoveButton("Save");
+	RemoveButton("Solve");
+	RemoveButton("Solve Step-by-Step");
+	RemoveButton("Export Animation");
+	RemoveButton("Export Drawing");
+	RemoveButton("Explore");
+	RemoveButton("Zoom In");
+	RemoveButton("Zoom Out");
+	RemoveButton("Fit");
+	RemoveClickListener();
+}
+
+/***********/
+/* Solving */
+/***********/
+
+/*
+ * Starts solving the puzzle on a background thread, so that the window keeps responding. While the solve runs,
+ * the only buttons are "Quit" and "Cancel", and a timer shows the progress every SOLVE_PROGRESS_INTERVAL seconds.
+ * When the worker is done, it posts finishSolve to the event loop, which animates the solution with the given
+ * pause, as drawPuzzle uses it. There is only ever one solve at a time, so a single job is reused. "Quit" is
+ * replaced by quitSolveAction until the solve is over, so that the worker is stopped before the program ends.
+ */
+void startSolve(Vector<triangleT> & triangles, double pause) {
+	static solveJobT job;
+	fillBackground("white");
+	job.triangles = &triangles;
+	job.puzzle = triangles;
+	job.solution.clear();
+	job.pause = pause;
+	job.progressFn = recordSolveProgress;
+	job.canceled = false;
+	job.nPlaced = 0;
+	job.nBoundaryLines = 0;
+	job.failed = false;
+	job.errorMessage = "";
+	removeModeButtons();
+	RemoveButton("Load Saved Puzzle");
+	RemoveButton("Quit");
+	AddButton("Quit", quitSolveAction, job);
+	AddButton("Cancel", cancelSolveAction, job);
+	job.timer = SetTimer(SOLVE_PROGRESS_INTERVAL, showSolveProgress, job);
+	job.worker = std::thread(solveWorker, std::ref(job));
+}
+
+/*
+ * Solves the puzzle of a background solve and posts finishSolve to the event loop. An error in the solve, such as
+ * a puzzle with no solution, is saved for finishSolve to report instead of ending the program.
+ */
+void solveWorker(solveJobT & job) {
+	try {
+		job.solution = solve(job.puzzle, &job);
+	} catch (ErrorException & ex) {
+		job.failed = true;
+		job.errorMessage = ex.getMessage();
+	}
+	PostAction(finishSolve, job);
+}
+
+/*
+ * Saves the progress of a background solve for showSolveProgress. This runs on the worker thread, so it only
+ * stores the numbers.
+ */
+void recordSolveProgress(solveJobT & job, int nPlaced, int nBoundaryLines) {
+	job.nPlaced = nPlaced;
+	job.nBoundaryLines = nBoundaryLines;
+}
+
+/*
+ * Shows how far a background solve has come at the bottom of the screen.
+ */
+void showSolveProgress(solveJobT & job) {
+	string progress = "Solving: " + IntegerToString(job.nPlaced) + " of " + IntegerToString(job.puzzle.size())
+		+ " triangles placed, " + IntegerToString(job.nBoundaryLines) + " boundary lines";
+	SetPenColor("white");
+	FillBox(0, WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT, WINDOW_WIDTH, 30);
+	SetPointSize(14);
+	SetPenColor("black");
+	SetFont("Helvetica");
+	SetStyle(0);
+	MovePen((WINDOW_WIDTH - TextStringWidth(progress))/2, WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT + 25);
+	DrawTextString(progress);
+	UpdateDisplay();
+}
+
+/*
+ * Ends a background solve on the event loop's thread: stops the progress display, restores the buttons, and then
+ * animates the solution or reports why there is none. A click on "Cancel" can arrive after the worker has already
+ * posted this, so the solve only counts as canceled if it stopped before placing every triangle.
+ */
+void finishSolve(solveJobT & job) {
+	job.worker.join();
+	CancelTimer(job.timer);
+	SetPenColor("white");
+	FillBox(0, WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT, WINDOW_WIDTH, 30);
+	RemoveButton("Quit");
+	RemoveButton("Cancel");
+	AddButton("Quit", quitAction, *job.triangles);
+	AddButton("Load Saved Puzzle", loadSavedPuzzleAction, *job.triangles);
+	addAnalyzeModeButtons(*job.triangles);
+	if (job.failed) {
+		cout << "\n" << job.errorMessage << endl;
+	} else if (job.solution.size() < job.puzzle.size()) {
+		cout << "\nSolving canceled." << endl;
+	} else {
+		printSolution(job.solution);
+		drawPuzzle(job.solution, job.pause, "green", "blue", "black");
+	}
+}
+
 /************/
 /* Graphics */
 /************/
@@ -472,113 +929,602 @@ void fillBackground(string color) {
 }
 
 /*
- * Draws the puzzle border and triangles. The puzzle is centered in the middle of the screen and scaled
- * by a scaleFactor, calculated such that the minimum margin on any side is 50 pixels. A pause value of 
- * -1 skips an animation of the triangles falling into place, and a pause value of 0 separates the
+ * Draws the puzzle border and triangles. The puzzle is centered in the middle of the screen and scaled as
+ * fitTransform describes, and the shards for all the triangles are worked out before any are drawn. A pause
+ * value of -1 skips an animation of the triangles falling into place, and a pause value of 0 separates the
  * animation of each triangle with a mouse click.
  */
 void drawPuzzle(Vector<triangleT> & triangles, double pause, string highlightColor, string fillColor, string outlineColor) {
 	fillBackground("white");
+	sceneT scene;
+	initScene(scene);
 	puzzleBorderT puzzleBorder = findPuzzleBorder(triangles);
-	int rawWidth = puzzleBorder.maxX - puzzleBorder.minX;
-	int rawHeight = puzzleBorder.maxY - puzzleBorder.minY;
-	double xScaleFactor = (WINDOW_WIDTH - 100)/rawWidth;
-	double yScaleFactor = (WINDOW_HEIGHT - 100)/rawHeight;
-	double scaleFactor = min(xScaleFactor, yScaleFactor);
-	double width = scaleFactor*rawWidth;
-	double height = scaleFactor*rawHeight;
-	double xMargin = (WINDOW_WIDTH-width)/2;
-	double yMargin = (WINDOW_HEIGHT-height)/2;
-	for (int triangleCounter = 0; triangleCounter < triangles.size(); triangleCounter++) {
-		if (pause != -1) {
+	viewTransformT transform = fitTransform(puzzleBorder);
+	Vector<shardT> shards = createShards(triangles, transform, fillColor, outlineColor);
+	if (pause == -1) {
+		Vector<int> indices;
+		for (int triangleCounter = 0; triangleCounter < triangles.size(); triangleCounter++) {
+			indices.add(triangleCounter);
+		}
+		drawShards(shards, indices);
+	} else {
+		for (int triangleCounter = 0; triangleCounter < triangles.size(); triangleCounter++) {
 			drawTriangleNum(triangles, triangleCounter);
-			SetPenColor(highlightColor);	
-			animateFallingTriangle(triangles[triangleCounter], scaleFactor, xMargin - puzzleBorder.minX*scaleFactor, 
-				yMargin + puzzleBorder.minY*scaleFactor, height);
+			animateFallingTriangle(scene, triangles[triangleCounter], transform, highlightColor);
 			Pause(pause);
 			if (pause == 0) GetMouseClick();
+			addShardToScene(scene, shards[triangleCounter]);
 		}
-		SetPenColor(fillColor);
-		drawFilledTriangle(triangles[triangleCounter], scaleFactor, xMargin - puzzleBorder.minX*scaleFactor, 
-			yMargin + puzzleBorder.minY*scaleFactor, height);
-		SetPenColor(outlineColor);
-		drawTriangle(triangles[triangleCounter], scaleFactor, xMargin - puzzleBorder.minX*scaleFactor, 
-			yMargin + puzzleBorder.minY*scaleFactor, height);
-
 	}
 	SetPenColor("white");
 	FillBox(0, WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT, WINDOW_WIDTH, 30);
 }
 
 /*
- * Animates a triangle falling from the top of the screen.
+ * Animates a triangle falling from the top of the screen into the place transform gives it, in the given color.
+ * The fall takes FALL_DURATION seconds divided by speed, whatever the size of the window, and is drawn at most
+ * ANIMATION_FRAME_RATE times a second. The position in each frame comes from the time the frame is due, so if
+ * drawing falls behind, frames are skipped rather than slowing the fall down. Between frames, only the area the
+ * triangle is leaving is repainted from the scene, which restores any placed triangles it passed over.
+ */
+void animateFallingTriangle(sceneT & scene, triangleT & triangle, viewTransformT & transform, string color, double speed) {
+	double startY = transform.bounds.height - WINDOW_HEIGHT;
+	int nFrames = (speed > 0) ? int(FALL_DURATION / speed * ANIMATION_FRAME_RATE) : 0;
+	double startTime = currentTime();
+	int frame = 0;
+	viewTransformT frameTransform = transform;
+	while (true) {
+		frameTransform.yOffset = (frame < nFrames) ? startY + (transform.yOffset - startY) * frame / nFrames : transform.yOffset;
+		shardT shard = createShard(triangle, frameTransform, color);
+		drawShard(shard);
+		UpdateDisplay();
+		if (frame >= nFrames) break;
+		double elapsed = currentTime() - startTime;
+		frame = max(frame + 1, int(elapsed * ANIMATION_FRAME_RATE));
+		Pause(max(0.0, double(frame) / ANIMATION_FRAME_RATE - elapsed));
+		repaintSceneRect(scene, shard.bounds);
+	}
+}
+
+/*
+ * Sets format to the kind of export that target asks for, returning false if it does not name one.
  */
-void animateFallingTriangle(triangleT & triangle, double scaleFactor, double xMargin, double yMargin, double height, double density) {
-	for (int y = -WINDOW_HEIGHT; y <= yMargin; y++) {
-		drawFilledTriangle(triangle, scaleFactor, xMargin, y, height, density);
-		Pause(0.00025);
-		if (y != yMargin) {
-			SetEraseMode(true);
-			drawFilledTriangle(triangle, scaleFactor, xMargin, y, height, density);
-			SetEraseMode(false);
+bool getExportFormat(string target, exportFormatT & format) {
+	string extension = (target.length() >= 4) ? ConvertToLowerCase(target.substr(target.length() - 4)) : "";
+	if (target.length() > 1 && target[0] == '|') {
+		format = RawStream;
+	} else if (extension == ".png") {
+		format = PNGFrames;
+	} else if (extension == ".ppm") {
+		format = PPMFrames;
+	} else {
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Returns the name of the image file for the given frame of an export to target, which is target with the frame
+ * number, padded to six digits, inserted before the extension.
+ */
+string exportFileName(string target, int frameNumber) {
+	char digits[MAX_INTEGER_CHARS];
+	int nDigits = FormatInteger(frameNumber, digits, MAX_INTEGER_CHARS);
+	return target.substr(0, target.length() - 4) + string(max(0, 6 - nDigits), '0') + string(digits, nDigits)
+		+ target.substr(target.length() - 4);
+}
+
+/*
+ * Renders the same animation drawPuzzle shows, without the triangle numbers, as a sequence of frames at
+ * ANIMATION_FRAME_RATE frames per second, and returns the number of frames. Each triangle's fall is rendered
+ * separately, so the work is shared among one thread per processor, each taking the next triangle that no thread
+ * has started and drawing on a canvas of its own. A thread keeps its own scene of placed shards, which it brings
+ * up to date by adding the shards placed since the last triangle it rendered. Image files are written as soon as
+ * they are rendered. Raw frames are collected for each triangle and written to the pipe in order. SIGPIPE is ignored
+ * while the pipe is open, so a command that exits early makes the write fail with an error instead of ending the
+ * program.
+ */
+int exportAnimation(Vector<triangleT> & triangles, string target, string highlightColor, string fillColor, string outlineColor) {
+	exportJobT job;
+	job.triangles = &triangles;
+	getExportFormat(target, job.format);
+	job.target = target;
+	puzzleBorderT puzzleBorder = findPuzzleBorder(triangles);
+	job.transform = fitTransform(puzzleBorder);
+	job.placedShards = createShards(triangles, job.transform, fillColor, outlineColor);
+	job.highlightColor = highlightColor;
+	job.framesPerTriangle = int(FALL_DURATION * ANIMATION_FRAME_RATE) + 1;
+	job.nextTriangle = 0;
+	job.failed = false;
+	job.nextToWrite = 0;
+	job.pipe = NULL;
+	void (*sigpipeHandler)(int) = SIG_DFL;
+	if (job.format == RawStream) {
+		job.pipe = popen(target.substr(1).c_str(), "w");
+		if (job.pipe == NULL) Error("Can't run " + target.substr(1));
+		sigpipeHandler = signal(SIGPIPE, SIG_IGN);
+	}
+	int nThreads = max(1, min(int(std::thread::hardware_concurrency()), triangles.size() + 1));
+	std::thread *threads = new std::thread[nThreads];
+	for (int i = 0; i < nThreads; i++) {
+		threads[i] = std::thread(exportWorker, std::ref(job));
+	}
+	for (int i = 0; i < nThreads; i++) {
+		threads[i].join();
+	}
+	delete[] threads;
+	if (job.pipe != NULL) {
+		if (pclose(job.pipe) != 0 && !job.failed) {
+			job.failed = true;
+			job.errorMessage = "The command " + target.substr(1) + " failed";
 		}
+		signal(SIGPIPE, sigpipeHandler);
 	}
+	if (job.failed) Error(job.errorMessage);
+	return triangles.size() * job.framesPerTriangle + 1;
 }
 
 /*
- * Draws a filled triangle with the specified scaleFactor, which adjusts for the size of the graphics window.
+ * Renders triangles for an export until none are left. The frames of triangle k begin at frame number
+ * k * framesPerTriangle, and one last frame after the falls shows the finished puzzle. An error in any thread
+ * stops all of them, and its message is saved for exportAnimation to report.
  */
-void drawFilledTriangle(triangleT & triangle, double scaleFactor, double xMargin, double yMargin, double height, double density) {
-	if (density != 0) StartFilledRegion(density);
-	MovePen(triangle.sides[0].x1*scaleFactor + xMargin, height + yMargin - triangle.sides[0].y1*scaleFactor);
+void exportWorker(exportJobT & job) {
+	try {
+		Vector<triangleT> & triangles = *job.triangles;
+		OffscreenGraphics canvas((int) WINDOW_WIDTH, (int) WINDOW_HEIGHT);
+		sceneT scene;
+		initScene(scene);
+		int nPlaced = 0;
+		string frames;
+		while (!job.failed) {
+			int triangleCounter = job.nextTriangle++;
+			if (triangleCounter > triangles.size()) break;
+			for (; nPlaced < triangleCounter; nPlaced++) {
+				addShardToScene(scene, job.placedShards[nPlaced], &canvas);
+			}
+			int firstFrame = triangleCounter * job.framesPerTriangle;
+			if (triangleCounter == triangles.size()) {
+				exportFrame(job, canvas, firstFrame, frames);
+			} else {
+				double startY = job.transform.bounds.height - WINDOW_HEIGHT;
+				int lastFrame = job.framesPerTriangle - 1;
+				viewTransformT frameTransform = job.transform;
+				for (int frame = 0; frame <= lastFrame; frame++) {
+					frameTransform.yOffset = startY + (job.transform.yOffset - startY) * frame / lastFrame;
+					shardT shard = createShard(triangles[triangleCounter], frameTransform, job.highlightColor);
+					drawShard(shard, &canvas);
+					exportFrame(job, canvas, firstFrame + frame, frames);
+					repaintSceneRect(scene, shard.bounds, &canvas);
+				}
+			}
+			if (job.format == RawStream) writeFramesInTurn(job, triangleCounter, frames);
+		}
+	} catch (ErrorException & ex) {
+		std::lock_guard<std::mutex> guard(job.lock);
+		if (!job.failed) job.errorMessage = ex.getMessage();
+		job.failed = true;
+		job.turn.notify_all();
+	}
+}
+
+/*
+ * Saves the canvas as the given frame: as a numbered image file named after the export target, or, for a raw
+ * stream, by adding its pixels to frames.
+ */
+void exportFrame(exportJobT & job, OffscreenGraphics & canvas, int frameNumber, string & frames) {
+	if (job.format == RawStream) {
+		frames.append((const char *) canvas.getPixels(), 4 * canvas.getWidth() * canvas.getHeight());
+		return;
+	}
+	string fileName = exportFileName(job.target, frameNumber);
+	if (job.format == PNGFrames) {
+		canvas.writePNG(fileName);
+	} else {
+		canvas.writePPM(fileName);
+	}
+}
+
+/*
+ * Waits until the frames of every earlier triangle have been written to the pipe, then writes this triangle's
+ * frames and lets the thread holding the next triangle go ahead.
+ */
+void writeFramesInTurn(exportJobT & job, int triangleCounter, string & frames) {
+	bool written;
+	{
+		std::unique_lock<std::mutex> lock(job.lock);
+		while (job.nextToWrite != triangleCounter && !job.failed) {
+			job.turn.wait(lock);
+		}
+		if (job.failed) return;
+		written = fwrite(frames.data(), 1, frames.length(), job.pipe) == frames.length();
+		job.nextToWrite++;
+		job.turn.notify_all();
+	}
+	frames.clear();
+	if (!written) Error("Can't write to " + job.target.substr(1));
+}
+
+/*
+ * Empties the scene and sizes its buckets to cover the puzzle area of the window.
+ */
+void initScene(sceneT & scene) {
+	scene.shards.clear();
+	scene.paintStamps.clear();
+	scene.currentStamp = 0;
+	int rows = int(ceil((WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT) / SCENE_BUCKET_SIZE));
+	int cols = int(ceil(WINDOW_WIDTH / SCENE_BUCKET_SIZE));
+	scene.buckets.resize(rows, cols);
+}
+
+/*
+ * Returns the shard for a triangle placed in the window by transform. An empty outlineColor means the shard is
+ * drawn without an outline.
+ */
+shardT createShard(triangleT & triangle, viewTransformT & transform, string fillColor, string outlineColor) {
+	shardT shard;
 	for (int side = 0; side < 3; side++) {
-		lineT line = triangle.sides[side];
-		DrawLine((line.x2 - line.x1)*scaleFactor, -(line.y2 - line.y1)*scaleFactor);
+		shard.x[side] = triangle.sides[side].x1;
+		shard.y[side] = triangle.sides[side].y1;
 	}
-	if (density != 0) EndFilledRegion();
+	transformVertices(transform, shard.x, shard.y, 3);
+	shard.fillColor = fillColor;
+	shard.outlineColor = outlineColor;
+	setShardBounds(shard);
+	return shard;
 }
 
 /*
- * Draws a filled triangle with a scaleFactor calculated from a given puzzleBorder.
+ * Returns the shards for a list of triangles, all in the same colors, in the same order. The corners of all the
+ * triangles are gathered into two arrays and transformed in a single pass, rather than three at a time.
  */
-void drawFilledTriangle(triangleT & triangle, puzzleBorderT & puzzleBorder) {
-	int rawWidth = puzzleBorder.maxX - puzzleBorder.minX;
-	int rawHeight = puzzleBorder.maxY - puzzleBorder.minY;
-	double xScaleFactor = (WINDOW_WIDTH - 100)/rawWidth;
-	double yScaleFactor = (WINDOW_HEIGHT - 100)/rawHeight;
-	double scaleFactor = min(xScaleFactor, yScaleFactor);
-	double width = scaleFactor*rawWidth;
-	double height = scaleFactor*rawHeight;
-	double xMargin = (WINDOW_WIDTH-width)/2;
-	double yMargin = (WINDOW_HEIGHT-height)/2;
-	drawFilledTriangle(triangle, scaleFactor, xMargin - puzzleBorder.minX*scaleFactor, 
-			yMargin + puzzleBorder.minY*scaleFactor, height);
+Vector<shardT> createShards(Vector<triangleT> & triangles, viewTransformT & transform, string fillColor, string outlineColor) {
+	int nVertices = 3 * triangles.size();
+	double *x = new double[nVertices];
+	double *y = new double[nVertices];
+	for (int i = 0; i < triangles.size(); i++) {
+		for (int side = 0; side < 3; side++) {
+			x[3*i + side] = triangles[i].sides[side].x1;
+			y[3*i + side] = triangles[i].sides[side].y1;
+		}
+	}
+	transformVertices(transform, x, y, nVertices);
+	Vector<shardT> shards(triangles.size());
+	for (int i = 0; i < triangles.size(); i++) {
+		shardT shard;
+		for (int side = 0; side < 3; side++) {
+			shard.x[side] = x[3*i + side];
+			shard.y[side] = y[3*i + side];
+		}
+		shard.fillColor = fillColor;
+		shard.outlineColor = outlineColor;
+		setShardBounds(shard);
+		shards.add(shard);
+	}
+	delete[] x;
+	delete[] y;
+	return shards;
 }
 
 /*
- * Draws a filled triangle whose scaleFactor is calculated by the the default puzzleBorder used when creating 
- * a new puzzle.
+ * Sets the bounds of a shard to the rectangle around its corners, widened by a pixel on every side to cover the
+ * outline.
  */
-void drawFilledTriangle(triangleT & triangle) {
-	puzzleBorderT puzzleBorder;
-	puzzleBorder.minX = 0;
-	puzzleBorder.minY = 0;
-	puzzleBorder.maxX = (WINDOW_WIDTH - 2*CREATE_PUZZLE_X_MARGIN) / CREATE_PUZZLE_STEP;
-	puzzleBorder.maxY = (WINDOW_HEIGHT - 2*CREATE_PUZZLE_Y_MARGIN) / CREATE_PUZZLE_STEP;
-	drawFilledTriangle(triangle, puzzleBorder);
+void setShardBounds(shardT & shard) {
+	double minX = min(shard.x[0], min(shard.x[1], shard.x[2]));
+	double minY = min(shard.y[0], min(shard.y[1], shard.y[2]));
+	double maxX = max(shard.x[0], max(shard.x[1], shard.x[2]));
+	double maxY = max(shard.y[0], max(shard.y[1], shard.y[2]));
+	shard.bounds.x = minX - 1;
+	shard.bounds.y = minY - 1;
+	shard.bounds.width = maxX - minX + 2;
+	shard.bounds.height = maxY - minY + 2;
+}
+
+/*
+ * Adds a shard to the scene, records it in every bucket its bounds overlap, and draws it in the window or, if
+ * canvas is not NULL, on the canvas.
+ */
+void addShardToScene(sceneT & scene, shardT & shard, OffscreenGraphics *canvas) {
+	int index = scene.shards.size();
+	scene.shards.add(shard);
+	scene.paintStamps.add(0);
+	int minRow = max(0, int(floor(shard.bounds.y / SCENE_BUCKET_SIZE)));
+	int maxRow = min(scene.buckets.numRows() - 1, int(floor((shard.bounds.y + shard.bounds.height) / SCENE_BUCKET_SIZE)));
+	int minCol = max(0, int(floor(shard.bounds.x / SCENE_BUCKET_SIZE)));
+	int maxCol = min(scene.buckets.numCols() - 1, int(floor((shard.bounds.x + shard.bounds.width) / SCENE_BUCKET_SIZE)));
+	for (int row = minRow; row <= maxRow; row++) {
+		for (int col = minCol; col <= maxCol; col++) {
+			scene.buckets[row][col].add(index);
+		}
+	}
+	drawShard(shard, canvas);
+}
+
+/*
+ * Repaints one rectangle of the puzzle area from the scene: the rectangle is cleared to the background, and the
+ * shards whose bounds overlap it are redrawn in the order they were added. Only the buckets under the rectangle
+ * are consulted, so the cost depends on the size of the rectangle rather than on the number of shards. The
+ * repainting happens in the window or, if canvas is not NULL, on the canvas.
+ */
+void repaintSceneRect(sceneT & scene, rectT rect, OffscreenGraphics *canvas) {
+	double x1 = max(0.0, rect.x);
+	double y1 = max(0.0, rect.y);
+	double x2 = min(WINDOW_WIDTH, rect.x + rect.width);
+	double y2 = min(WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT, rect.y + rect.height);
+	if (x1 >= x2 || y1 >= y2) return;
+	if (canvas != NULL) {
+		canvas->setPenColor("white");
+		canvas->fillBox(x1, y1, x2 - x1, y2 - y1);
+	} else {
+		SetPenColor("white");
+		FillBox(x1, y1, x2 - x1, y2 - y1);
+	}
+	scene.currentStamp++;
+	Vector<int> overlapping;
+	int maxRow = min(scene.buckets.numRows() - 1, int(floor(y2 / SCENE_BUCKET_SIZE)));
+	int maxCol = min(scene.buckets.numCols() - 1, int(floor(x2 / SCENE_BUCKET_SIZE)));
+	for (int row = int(floor(y1 / SCENE_BUCKET_SIZE)); row <= maxRow; row++) {
+		for (int col = int(floor(x1 / SCENE_BUCKET_SIZE)); col <= maxCol; col++) {
+			Vector<int> & bucket = scene.buckets[row][col];
+			for (int i = 0; i < bucket.size(); i++) {
+				int index = bucket[i];
+				rectT & bounds = scene.shards[index].bounds;
+				if (scene.paintStamps[index] != scene.currentStamp && bounds.x < x2 && bounds.x + bounds.width > x1
+				    && bounds.y < y2 && bounds.y + bounds.height > y1) {
+					scene.paintStamps[index] = scene.currentStamp;
+					overlapping.add(index);
+				}
+			}
+		}
+	}
+	if (overlapping.isEmpty()) return;
+	sort(&overlapping[0], &overlapping[0] + overlapping.size());
+	drawShards(scene.shards, overlapping, canvas);
+}
+
+/*
+ * Draws a shard filled with its fill color and, if it has one, outlined in its outline color. The shard is drawn
+ * in the window or, if canvas is not NULL, on the canvas.
+ */
+void drawShard(shardT & shard, OffscreenGraphics *canvas) {
+	if (canvas != NULL) {
+		canvas->setPenColor(shard.fillColor);
+		canvas->startFilledRegion(1.0);
+		canvas->movePen(shard.x[0], shard.y[0]);
+		for (int i = 0; i < 3; i++) {
+			canvas->drawLine(shard.x[(i + 1) % 3] - shard.x[i], shard.y[(i + 1) % 3] - shard.y[i]);
+		}
+		canvas->endFilledRegion();
+		if (shard.outlineColor == "") return;
+		canvas->setPenColor(shard.outlineColor);
+		canvas->movePen(shard.x[0], shard.y[0]);
+		for (int i = 0; i < 3; i++) {
+			canvas->drawLine(shard.x[(i + 1) % 3] - shard.x[i], shard.y[(i + 1) % 3] - shard.y[i]);
+		}
+		return;
+	}
+	SetPenColor(shard.fillColor);
+	StartFilledRegion(1.0);
+	MovePen(shard.x[0], shard.y[0]);
+	for (int i = 0; i < 3; i++) {
+		DrawLine(shard.x[(i + 1) % 3] - shard.x[i], shard.y[(i + 1) % 3] - shard.y[i]);
+	}
+	EndFilledRegion();
+	if (shard.outlineColor == "") return;
+	SetPenColor(shard.outlineColor);
+	MovePen(shard.x[0], shard.y[0]);
+	for (int i = 0; i < 3; i++) {
+		DrawLine(shard.x[(i + 1) % 3] - shard.x[i], shard.y[(i + 1) % 3] - shard.y[i]);
+	}
+}
+
+/*
+ * Sets up the viewer for a solved puzzle: sizes the cells so that each one holds about VIEW_SHARDS_PER_CELL
+ * triangles, records each triangle in every cell its bounds overlap, and fits the view to the whole puzzle.
+ */
+void initViewer(viewerT & viewer, Vector<triangleT> & solution) {
+	viewer.solution = solution;
+	viewer.puzzleBorder = findPuzzleBorder(solution);
+	puzzleBorderT & border = viewer.puzzleBorder;
+	double rawWidth = max(1, border.maxX - border.minX);
+	double rawHeight = max(1, border.maxY - border.minY);
+	viewer.cellSize = sqrt(rawWidth * rawHeight * VIEW_SHARDS_PER_CELL / solution.size());
+	int rows = max(1, int(ceil(rawHeight / viewer.cellSize)));
+	int cols = max(1, int(ceil(rawWidth / viewer.cellSize)));
+	viewer.cells.resize(rows, cols);
+	viewer.paintStamps.clear();
+	viewer.currentStamp = 0;
+	for (int i = 0; i < solution.size(); i++) {
+		Vector<lineT> & sides = solution[i].sides;
+		int minX = min(sides[0].x1, min(sides[1].x1, sides[2].x1));
+		int minY = min(sides[0].y1, min(sides[1].y1, sides[2].y1));
+		int maxX = max(sides[0].x1, max(sides[1].x1, sides[2].x1));
+		int maxY = max(sides[0].y1, max(sides[1].y1, sides[2].y1));
+		int minRow = max(0, int(floor((minY - border.minY) / viewer.cellSize)));
+		int maxRow = min(rows - 1, int(floor((maxY - border.minY) / viewer.cellSize)));
+		int minCol = max(0, int(floor((minX - border.minX) / viewer.cellSize)));
+		int maxCol = min(cols - 1, int(floor((maxX - border.minX) / viewer.cellSize)));
+		for (int row = minRow; row <= maxRow; row++) {
+			for (int col = minCol; col <= maxCol; col++) {
+				viewer.cells[row][col].add(i);
+			}
+		}
+		viewer.paintStamps.add(0);
+	}
+	fitView(viewer);
+}
+
+/*
+ * Centers the view on the puzzle and sets the zoom, as drawPuzzle does, so that the minimum margin on any side
+ * of the puzzle area is 50 pixels.
+ */
+void fitView(viewerT & viewer) {
+	puzzleBorderT & border = viewer.puzzleBorder;
+	double rawWidth = max(1, border.maxX - border.minX);
+	double rawHeight = max(1, border.maxY - border.minY);
+	viewer.fitZoom = min((WINDOW_WIDTH - 100)/rawWidth, (WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT - 100)/rawHeight);
+	viewer.zoom = viewer.fitZoom;
+	viewer.centerX = (border.minX + border.maxX) / 2.0;
+	viewer.centerY = (border.minY + border.maxY) / 2.0;
+}
+
+/*
+ * Draws the part of the puzzle in view. Only the cells under the window are consulted, so the cost depends on
+ * how much of the puzzle is in view rather than on the number of triangles. Once the cells are smaller than
+ * VIEW_MERGE_SIZE pixels, the triangles are too small to tell apart, and each row of cells is drawn as a few
+ * boxes instead. Otherwise each triangle in view is drawn, skipping any smaller than a pixel, outlining only
+ * those at least VIEW_OUTLINE_SIZE pixels across, and labeling only those at least VIEW_LABEL_SIZE pixels across.
+ */
+void drawView(viewerT & viewer) {
+	TRACE_SCOPE("drawView");
+	fillBackground("white");
+	puzzleBorderT & border = viewer.puzzleBorder;
+	double viewHeight = WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT;
+	double halfWidth = WINDOW_WIDTH / 2 / viewer.zoom;
+	double halfHeight = viewHeight / 2 / viewer.zoom;
+	int minRow = max(0, int(floor((viewer.centerY - halfHeight - border.minY) / viewer.cellSize)));
+	int maxRow = min(viewer.cells.numRows() - 1, int(floor((viewer.centerY + halfHeight - border.minY) / viewer.cellSize)));
+	int minCol = max(0, int(floor((viewer.centerX - halfWidth - border.minX) / viewer.cellSize)));
+	int maxCol = min(viewer.cells.numCols() - 1, int(floor((viewer.centerX + halfWidth - border.minX) / viewer.cellSize)));
+	viewTransformT transform = createTransform(border, viewer.zoom, WINDOW_WIDTH/2 - viewer.centerX * viewer.zoom,
+		viewHeight/2 + viewer.centerY * viewer.zoom);
+	if (viewer.cellSize * viewer.zoom < VIEW_MERGE_SIZE) {
+		drawMergedCells(viewer, transform, minRow, maxRow, minCol, maxCol);
+	} else {
+		viewer.currentStamp++;
+		Vector<shardT> shards;
+		Vector<int> indices, visible;
+		for (int row = minRow; row <= maxRow; row++) {
+			for (int col = minCol; col <= maxCol; col++) {
+				Vector<int> & cell = viewer.cells[row][col];
+				for (int i = 0; i < cell.size(); i++) {
+					int index = cell[i];
+					if (viewer.paintStamps[index] == viewer.currentStamp) continue;
+					viewer.paintStamps[index] = viewer.currentStamp;
+					shardT shard = createShard(viewer.solution[index], transform, "blue");
+					double size = min(shard.bounds.width, shard.bounds.height) - 2;
+					if (max(shard.bounds.width, shard.bounds.height) - 2 < 1) continue;
+					if (size >= VIEW_OUTLINE_SIZE) shard.outlineColor = "black";
+					indices.add(shards.size());
+					shards.add(shard);
+					visible.add(index);
+				}
+			}
+		}
+		drawShards(shards, indices);
+		for (int i = 0; i < shards.size(); i++) {
+			if (min(shards[i].bounds.width, shards[i].bounds.height) - 2 >= VIEW_LABEL_SIZE) {
+				drawShardLabel(shards[i], viewer.solution[visible[i]].num);
+			}
+		}
+	}
+	SetPenColor("black");
+	MovePen(transform.bounds.x, transform.bounds.y);
+	DrawLine(transform.bounds.width, 0);
+	DrawLine(0, transform.bounds.height);
+	DrawLine(-transform.bounds.width, 0);
+	DrawLine(0, -transform.bounds.height);
+	SetPenColor("white");
+	FillBox(0, WINDOW_HEIGHT - CONTROL_STRIP_HEIGHT, WINDOW_WIDTH, 30);
+	UpdateDisplay();
+}
+
+/*
+ * Draws the cells in the given range that hold any triangles as filled boxes, merging each run of such cells in
+ * a row into a single box, so that a completed puzzle takes one box per row of cells.
+ */
+void drawMergedCells(viewerT & viewer, viewTransformT & transform, int minRow, int maxRow, int minCol, int maxCol) {
+	puzzleBorderT & border = viewer.puzzleBorder;
+	SetPenColor("blue");
+	for (int row = minRow; row <= maxRow; row++) {
+		double bottom = border.minY + row * viewer.cellSize;
+		double top = min(double(border.maxY), bottom + viewer.cellSize);
+		int col = minCol;
+		while (col <= maxCol) {
+			if (viewer.cells[row][col].isEmpty()) {
+				col++;
+				continue;
+			}
+			int startCol = col;
+			while (col <= maxCol && !viewer.cells[row][col].isEmpty()) col++;
+			double left = border.minX + startCol * viewer.cellSize;
+			double right = min(double(border.maxX), border.minX + col * viewer.cellSize);
+			FillBox(left * transform.scale + transform.xOffset, transform.yOffset - top * transform.scale,
+				(right - left) * transform.scale, (top - bottom) * transform.scale);
+		}
+	}
+}
+
+/*
+ * Writes a triangle's number in the middle of its shard.
+ */
+void drawShardLabel(shardT & shard, int num) {
+	string label = IntegerToString(num);
+	SetPointSize(12);
+	SetFont("Helvetica");
+	SetStyle(0);
+	SetPenColor("white");
+	MovePen((shard.x[0] + shard.x[1] + shard.x[2])/3 - TextStringWidth(label)/2,
+		(shard.y[0] + shard.y[1] + shard.y[2])/3 + GetFontAscent()/2);
+	DrawTextString(label);
+}
+
+/*
+ * Draws the shards at the given indices, as drawShard would draw them one at a time. In the window they are drawn
+ * with a single call to DrawTriangles, which needs the shards not to overlap and the ones with outlines to share
+ * an outline color, as they do in every set of placed shards this program draws.
+ */
+void drawShards(Vector<shardT> & shards, Vector<int> & indices, OffscreenGraphics *canvas) {
+	if (canvas != NULL) {
+		for (int i = 0; i < indices.size(); i++) {
+			drawShard(shards[indices[i]], canvas);
+		}
+		return;
+	}
+	shadedTriangleT *batch = new shadedTriangleT[indices.size()];
+	string outlineColor = "";
+	for (int i = 0; i < indices.size(); i++) {
+		shardT & shard = shards[indices[i]];
+		for (int corner = 0; corner < 3; corner++) {
+			batch[i].x[corner] = shard.x[corner];
+			batch[i].y[corner] = shard.y[corner];
+		}
+		batch[i].fillColor = shard.fillColor;
+		batch[i].outlined = (shard.outlineColor != "");
+		if (batch[i].outlined) outlineColor = shard.outlineColor;
+	}
+	DrawTriangles(batch, indices.size(), outlineColor);
+	delete[] batch;
+}
+
+/*
+ * Returns the time in seconds from an arbitrary starting point, for measuring intervals.
+ */
+double currentTime() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 }
 
 /*
- * Draws the outline of a triangle with the specified scaleFactor, which adjusts for the size of the graphics window.
+ * Returns the transform with the given scale and offsets for a puzzle with the given border.
  */
-void drawTriangle(triangleT & triangle, double scaleFactor, double xMargin, double yMargin, double height) {
-	drawFilledTriangle(triangle, scaleFactor, xMargin, yMargin, height, 0);
+viewTransformT createTransform(puzzleBorderT & puzzleBorder, double scale, double xOffset, double yOffset) {
+	viewTransformT transform;
+	transform.scale = scale;
+	transform.xOffset = xOffset;
+	transform.yOffset = yOffset;
+	transform.bounds.x = puzzleBorder.minX*scale + xOffset;
+	transform.bounds.y = yOffset - puzzleBorder.maxY*scale;
+	transform.bounds.width = (puzzleBorder.maxX - puzzleBorder.minX)*scale;
+	transform.bounds.height = (puzzleBorder.maxY - puzzleBorder.minY)*scale;
+	return transform;
 }
 
 /*
- * Draws the outline triangle with a scaleFactor calculated from a given puzzleBorder.
+ * Returns the transform that centers a puzzle in the window, scaled such that the minimum margin on any side
+ * is 50 pixels.
  */
-void drawTriangle(triangleT & triangle, puzzleBorderT & puzzleBorder) {
+viewTransformT fitTransform(puzzleBorderT & puzzleBorder) {
 	int rawWidth = puzzleBorder.maxX - puzzleBorder.minX;
 	int rawHeight = puzzleBorder.maxY - puzzleBorder.minY;
 	double xScaleFactor = (WINDOW_WIDTH - 100)/rawWidth;
@@ -588,29 +1534,63 @@ void drawTriangle(triangleT & triangle, puzzleBorderT & puzzleBorder) {
 	double height = scaleFactor*rawHeight;
 	double xMargin = (WINDOW_WIDTH-width)/2;
 	double yMargin = (WINDOW_HEIGHT-height)/2;
-	drawTriangle(triangle, scaleFactor, xMargin - puzzleBorder.minX*scaleFactor, 
-			yMargin + puzzleBorder.minY*scaleFactor, height);
+	return createTransform(puzzleBorder, scaleFactor, xMargin - puzzleBorder.minX*scaleFactor,
+		height + yMargin + puzzleBorder.minY*scaleFactor);
 }
 
 /*
- * Draws the outline of a triangle whose scaleFactor is calculated by the default puzzleBorder used when creating 
- * a new puzzle.
+ * Returns the transform for the grid used when creating a new puzzle.
  */
-void drawTriangle(triangleT & triangle) {
+viewTransformT createPuzzleTransform() {
 	puzzleBorderT puzzleBorder;
 	puzzleBorder.minX = 0;
 	puzzleBorder.minY = 0;
 	puzzleBorder.maxX = (WINDOW_WIDTH - 2*CREATE_PUZZLE_X_MARGIN) / CREATE_PUZZLE_STEP;
 	puzzleBorder.maxY = (WINDOW_HEIGHT - 2*CREATE_PUZZLE_Y_MARGIN) / CREATE_PUZZLE_STEP;
-	drawTriangle(triangle, puzzleBorder);
+	return fitTransform(puzzleBorder);
+}
+
+/*
+ * Transforms n points, whose coordinates are in the arrays x and y, from puzzle coordinates to window
+ * coordinates in place. The loop has no branches and each iteration is independent, so the compiler can
+ * vectorize it.
+ */
+void transformVertices(viewTransformT & transform, double x[], double y[], int n) {
+	double scale = transform.scale;
+	double xOffset = transform.xOffset;
+	double yOffset = transform.yOffset;
+	for (int i = 0; i < n; i++) {
+		x[i] = x[i]*scale + xOffset;
+		y[i] = yOffset - y[i]*scale;
+	}
+}
+
+/*
+ * Draws a filled triangle placed in the window by transform. A density of 0 draws only the outline.
+ */
+void drawFilledTriangle(triangleT & triangle, viewTransformT & transform, double density) {
+	if (density != 0) StartFilledRegion(density);
+	MovePen(triangle.sides[0].x1*transform.scale + transform.xOffset, transform.yOffset - triangle.sides[0].y1*transform.scale);
+	for (int side = 0; side < 3; side++) {
+		lineT line = triangle.sides[side];
+		DrawLine((line.x2 - line.x1)*transform.scale, -(line.y2 - line.y1)*transform.scale);
+	}
+	if (density != 0) EndFilledRegion();
+}
+
+/*
+ * Draws the outline of a triangle placed in the window by transform.
+ */
+void drawTriangle(triangleT & triangle, viewTransformT & transform) {
+	drawFilledTriangle(triangle, transform, 0);
 }
 
 /*
- * Draws a line with the specified scaleFactor, which adjusts for the size of the graphics window.
+ * Draws a line placed in the window by transform.
  */
-void drawLine(lineT & line, double scaleFactor, double xMargin, double yMargin, double height) {
-	MovePen(line.x1*scaleFactor + xMargin, height + yMargin - line.y1*scaleFactor);
-	DrawLine((line.x2 - line.x1)*scaleFactor, -(line.y2 - line.y1)*scaleFactor);
+void drawLine(lineT & line, viewTransformT & transform) {
+	MovePen(line.x1*transform.scale + transform.xOffset, transform.yOffset - line.y1*transform.scale);
+	DrawLine((line.x2 - line.x1)*transform.scale, -(line.y2 - line.y1)*transform.scale);
 }
 
 /*
@@ -627,11 +1607,18 @@ void drawPoint(pointT point, string color) {
  * Draws the number of the triangle currently being animated centered at the bottom of the screen.
  */
 void drawTriangleNum(Vector<triangleT> triangles, int triangleCounter) {
+	char digits[MAX_INTEGER_CHARS];
 	string solutionSoFar = "";
-	for (int i = 0; i < triangleCounter; i++) solutionSoFar += (IntegerToString(triangles[i].num) + "  ");
+	for (int i = 0; i < triangleCounter; i++) {
+		solutionSoFar.append(digits, FormatInteger(triangles[i].num, digits, MAX_INTEGER_CHARS));
+		solutionSoFar += "  ";
+	}
 	string solution = solutionSoFar;
-	for (int i = triangleCounter; i < triangles.size(); i++) solution += (IntegerToString(triangles[i].num) + "  ");
-	solution = solution.substr(0, solution.length() - 2);
+	for (int i = triangleCounter; i < triangles.size(); i++) {
+		solution.append(digits, FormatInteger(triangles[i].num, digits, MAX_INTEGER_CHARS));
+		solution += "  ";
+	}
+	solution.resize(solution.length() - 2);
 	SetPointSize(20);
 	SetPenColor("black");
 	SetFont("Helvetica");
@@ -724,9 +1711,8 @@ void saveFile(ofstream & outfile, Vector<triangleT> & triangles) {
  * Writes an int to a given ofstream.
  */
 void outfilePutInt(ofstream & outfile, int num) {
-	string numString = IntegerToString(num);
-	for (int digit = 0; digit < numString.size(); digit++)
-		outfile.put(numString[digit]);
+	char digits[MAX_INTEGER_CHARS];
+	outfile.write(digits, FormatInteger(num, digits, MAX_INTEGER_CHARS));
 }
 
 /*******************************/
@@ -734,23 +1720,22 @@ void outfilePutInt(ofstream & outfile, int num) {
 /*******************************/
 
 /*
- * Loads the contents of a specified file into a vector called triangles.
+ * Loads the contents of a specified file into a vector called triangles. The file is mapped into
+ * memory and its numbers are parsed in place, so no line or token strings are built along the way.
  */
-void readFile(ifstream & infile, Vector<triangleT> & triangles) {
-	string nextLine;
-	getline(infile, nextLine);
-	if (nextLine == "")	getline(infile, nextLine);
-	int numTriangles = StringToInteger(nextLine);
-	Scanner scanner;
-	scanner.setSpaceOption(Scanner::IgnoreSpaces);
+void readFile(string fileName, Vector<triangleT> & triangles) {
+	INSTRUMENT_SITE("readFile");
+	TRACE_SCOPE("readFile");
+	ViewScanner scanner;
+	scanner.setSpaceOption(ViewScanner::IgnoreSpaces);
+	if (!scanner.mapFile(fileName)) Error("Can't open " + fileName);
+	int numTriangles = scanner.nextInteger();
 	for (int t = 0; t < numTriangles; t++) {
-		getline(infile, nextLine);
-		scanner.setInput(nextLine);
 		Vector<pointT> points;
 		for (int pointCounter = 0; pointCounter < 3; pointCounter++) {
 			pointT point;
-			point.x = StringToInteger(scanner.nextToken());
-			point.y = StringToInteger(scanner.nextToken());
+			point.x = scanner.nextInteger();
+			point.y = scanner.nextInteger();
 			points.add(point);
 		}
 		triangleT newTriangle = createTriangle(points);
@@ -804,21 +1789,41 @@ lineT createLine(pointT a, pointT b) {
 /*
  * Solves the given puzzle.
  */
-Vector<triangleT> solve(Vector<triangleT> triangles) {
+Vector<triangleT> solve(Vector<triangleT> triangles, solveJobT *job) {
+	INSTRUMENT_SITE("solve");
+	TRACE_SCOPE("solve");
 	puzzleBorderT puzzleBorder = findPuzzleBorder(triangles);
 	Vector<triangleT> trianglesSoFar;
 	Vector<lineT> boundaryLines;
 	findStartingTriangles(triangles, trianglesSoFar, boundaryLines, puzzleBorder);
-	solveRec(triangles, trianglesSoFar, boundaryLines, puzzleBorder);
+	solveRec(triangles, trianglesSoFar, boundaryLines, puzzleBorder, job);
 	return trianglesSoFar;
 }
 
 /*
- * Recursive implementation of the solving algorithm. See the comments at the beginning of this file for an explanation
- * of the solving algorithm used.
+ * Implementation of the solving algorithm. See the comments at the beginning of this file for an explanation of the
+ * solving algorithm used. Each step of the recursion described there places one triangle and then goes on with the
+ * rest, with nothing left to do once the rest is placed, so it is written as a loop. This keeps the stack from growing
+ * with the number of triangles, which matters on the background thread, whose stack may be much smaller than the main
+ * thread's.
+ */
+void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT & puzzleBorder, solveJobT *job) {
+	TRACE_SCOPE("solveRec");
+	while (boundaryLines.size() > 0) {
+		if (job != NULL && job->canceled) return;
+		if (!placeNextTriangle(trianglesLeft, trianglesSoFar, boundaryLines, puzzleBorder)) {
+			Error("No solution! The puzzle cannot be solved.");
+		}
+		if (job != NULL) job->progressFn(*job, trianglesSoFar.size(), boundaryLines.size());
+	}
+}
+
+/*
+ * Moves the first triangle that can be dropped onto a boundary line from trianglesLeft to trianglesSoFar and updates
+ * boundaryLines to match, returning false if no triangle fits.
  */
-void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT & puzzleBorder) {
-	if (boundaryLines.size() == 0) return;
+bool placeNextTriangle(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT & puzzleBorder) {
+	TRACE_SCOPE("placeNextTriangle");
 	
 	for (int boundaryLineCounter = 0; boundaryLineCounter < boundaryLines.size(); boundaryLineCounter++) {	
 		lineT boundaryLine = boundaryLines[boundaryLineCounter];
@@ -835,17 +1840,20 @@ void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSo
 				if (compareLines(boundaryLine, line) && doesNotBlock(boundaryLines, triangle, line, obstructedLine)) {
 					
 					// Update boundaryLines.
-					boundaryLines.removeAt(boundaryLineCounter);	
-					for (int sideCounter2 = 0; sideCounter2 < 3; sideCounter2++)
-						if (sideCounter2 != sideCounter && !isOnBorder(triangle.sides[sideCounter2], puzzleBorder))
-							boundaryLines.add(triangle.sides[sideCounter2]);
-					for (int boundaryLineCounter2 = 0; boundaryLineCounter2 < boundaryLines.size(); boundaryLineCounter2++) {
-						if (compareLines(boundaryLines[boundaryLineCounter2], obstructedLine)) {
-							boundaryLines.removeAt(boundaryLineCounter2);
-							boundaryLineCounter2--;
+					{
+						TRACE_SCOPE("updateBoundaryLines");
+						boundaryLines.removeAt(boundaryLineCounter);	
+						for (int sideCounter2 = 0; sideCounter2 < 3; sideCounter2++)
+							if (sideCounter2 != sideCounter && !isOnBorder(triangle.sides[sideCounter2], puzzleBorder))
+								boundaryLines.add(triangle.sides[sideCounter2]);
+						for (int boundaryLineCounter2 = 0; boundaryLineCounter2 < boundaryLines.size(); boundaryLineCounter2++) {
+							if (compareLines(boundaryLines[boundaryLineCounter2], obstructedLine)) {
+								boundaryLines.removeAt(boundaryLineCounter2);
+								boundaryLineCounter2--;
+							}
 						}
+						removeDuplicateBoundaryLines(boundaryLines);
 					}
-					removeDuplicateBoundaryLines(boundaryLines);
 
 					// Update trianglesSoFar.
 					trianglesSoFar.add(triangle);
@@ -853,15 +1861,13 @@ void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSo
 					// Update trianglesLeft.
 					trianglesLeft.removeAt(trianglesLeftCounter);
 
-					solveRec(trianglesLeft, trianglesSoFar, boundaryLines, puzzleBorder);
-					return;
+					return true;
 				}
 			}
 		}
 	}
 
-	Error("No solution! The puzzle cannot be solved.");
-	return;
+	return false;
 }
 
 /*
@@ -869,6 +1875,7 @@ void solveRec(Vector<triangleT> & trianglesLeft, Vector<triangleT> & trianglesSo
  * those values.
  */
 puzzleBorderT findPuzzleBorder(Vector<triangleT> triangles) {
+	TRACE_SCOPE("findPuzzleBorder");
 	puzzleBorderT puzzleBorder;
 	puzzleBorder.minX = triangles[0].sides[0].x1;
 	puzzleBorder.minY = triangles[0].sides[0].y1;
@@ -893,6 +1900,7 @@ puzzleBorderT findPuzzleBorder(Vector<triangleT> triangles) {
  * Finds all the triangles that lie on the bottom side of the border and that are concave.
  */
 void findStartingTriangles(Vector<triangleT> & triangles, Vector<triangleT> & trianglesSoFar, Vector<lineT> & boundaryLines, puzzleBorderT puzzleBorder) {
+	TRACE_SCOPE("findStartingTriangles");
 	for (int triangleCounter = 0; triangleCounter < triangles.size(); triangleCounter++) {
 		for (int sideCounter = 0; sideCounter < 3; sideCounter++) {
 			triangleT triangle = triangles[triangleCounter];
@@ -1021,6 +2029,162 @@ void removeDuplicateBoundaryLines(Vector<lineT> & boundaryLines) {
 	}
 }
 
+/*
+ * Returns the wave of each triangle in the solution. The starting triangles, which touch no triangle dropped
+ * before them, form wave 0, and every other triangle belongs to the wave after the latest wave among the earlier
+ * triangles it shares a side with. The triangles of one wave share no sides, so they can be set in place together
+ * once the waves before them are done. A HashMap from each side to the wave of the triangle that placed it makes
+ * this a single pass over the solution.
+ */
+Vector<int> findWaves(Vector<triangleT> & solution) {
+	Vector<int> waves(solution.size());
+	HashMap<lineT, int> sideWaves(3 * solution.size());
+	for (int triangle = 0; triangle < solution.size(); triangle++) {
+		int wave = 0;
+		for (int side = 0; side < 3; side++) {
+			int *neighborWave = sideWaves.find(orderedLine(solution[triangle].sides[side]));
+			if (neighborWave != NULL) wave = max(wave, *neighborWave + 1);
+		}
+		waves.add(wave);
+		for (int side = 0; side < 3; side++) {
+			sideWaves.put(orderedLine(solution[triangle].sides[side]), wave);
+		}
+	}
+	return waves;
+}
+
+/*
+ * Returns the line with its endpoints in a fixed order, so that the two triangles on either side of a line
+ * produce the same lineT.
+ */
+lineT orderedLine(lineT line) {
+	if (line.x1 > line.x2 || (line.x1 == line.x2 && line.y1 > line.y2)) {
+		swap(line.x1, line.x2);
+		swap(line.y1, line.y2);
+	}
+	return line;
+}
+
+/*
+ * Writes the solution as an SVG drawing in puzzle coordinates, flipped so that y grows upward as it does in the
+ * puzzle files. Each wave is a group of its own, so that drawing programs can show or hide the waves as layers,
+ * and the colors of the waves repeat after SVG_WAVE_COLORS. Every triangle is labeled with its position in the
+ * drop order, counting from 1. The file is written in one pass: the triangles are sorted into waves with a
+ * counting sort of their indices, and the text is built in a buffer of SVG_BUFFER_SIZE characters that is written
+ * out whenever it fills, so the memory needed beyond the solution itself is a few integers per triangle.
+ */
+void writeSVG(ofstream & outfile, Vector<triangleT> & solution) {
+	puzzleBorderT puzzleBorder = findPuzzleBorder(solution);
+	int width = puzzleBorder.maxX - puzzleBorder.minX;
+	int height = puzzleBorder.maxY - puzzleBorder.minY;
+	Vector<int> waves = findWaves(solution);
+	int nWaves = 0;
+	for (int i = 0; i < waves.size(); i++) {
+		nWaves = max(nWaves, waves[i] + 1);
+	}
+	Vector<int> waveStarts;
+	for (int wave = 0; wave <= nWaves; wave++) {
+		waveStarts.add(0);
+	}
+	for (int i = 0; i < waves.size(); i++) {
+		waveStarts[waves[i] + 1]++;
+	}
+	for (int wave = 1; wave <= nWaves; wave++) {
+		waveStarts[wave] += waveStarts[wave - 1];
+	}
+	Vector<int> order(solution.size());
+	for (int i = 0; i < solution.size(); i++) {
+		order.add(0);
+	}
+	Vector<int> nextSlot = waveStarts;
+	for (int i = 0; i < waves.size(); i++) {
+		order[nextSlot[waves[i]]++] = i;
+	}
+	double scale = double(SVG_SIZE) / max(width, height);
+	double fontSize = 0.35 * sqrt(double(width) * height / solution.size());
+	string buffer;
+	buffer.reserve(SVG_BUFFER_SIZE + 256);
+	buffer += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+	svgPutReal(buffer, width * scale);
+	buffer += "\" height=\"";
+	svgPutReal(buffer, height * scale);
+	buffer += "\" viewBox=\"";
+	svgPutInt(buffer, puzzleBorder.minX);
+	buffer += " 0 ";
+	svgPutInt(buffer, width);
+	buffer += ' ';
+	svgPutInt(buffer, height);
+	buffer += "\">\n<style>\npolygon{stroke:#000;stroke-width:";
+	svgPutReal(buffer, 1 / scale);
+	buffer += ";stroke-linejoin:round}\ntext{font-family:Helvetica,sans-serif;font-size:";
+	svgPutReal(buffer, fontSize);
+	buffer += "px;text-anchor:middle;dominant-baseline:central}\n";
+	for (int color = 0; color < SVG_WAVE_COLORS; color++) {
+		buffer += ".w";
+		svgPutInt(buffer, color);
+		buffer += "{fill:hsl(";
+		svgPutInt(buffer, color * 360 / SVG_WAVE_COLORS);
+		buffer += ",70%,70%)}\n";
+	}
+	buffer += "</style>\n";
+	for (int wave = 0; wave < nWaves; wave++) {
+		buffer += "<g id=\"wave-";
+		svgPutInt(buffer, wave);
+		buffer += "\" class=\"w";
+		svgPutInt(buffer, wave % SVG_WAVE_COLORS);
+		buffer += "\">\n";
+		for (int slot = waveStarts[wave]; slot < waveStarts[wave + 1]; slot++) {
+			triangleT & triangle = solution[order[slot]];
+			double xSum = 0, ySum = 0;
+			buffer += "<polygon points=\"";
+			for (int side = 0; side < 3; side++) {
+				int x = triangle.sides[side].x1;
+				int y = puzzleBorder.maxY - triangle.sides[side].y1;
+				if (side > 0) buffer += ' ';
+				svgPutInt(buffer, x);
+				buffer += ',';
+				svgPutInt(buffer, y);
+				xSum += x;
+				ySum += y;
+			}
+			buffer += "\"/><text x=\"";
+			svgPutReal(buffer, xSum / 3);
+			buffer += "\" y=\"";
+			svgPutReal(buffer, ySum / 3);
+			buffer += "\">";
+			svgPutInt(buffer, order[slot] + 1);
+			buffer += "</text>\n";
+			svgFlush(outfile, buffer, SVG_BUFFER_SIZE);
+		}
+		buffer += "</g>\n";
+	}
+	buffer += "</svg>\n";
+	svgFlush(outfile, buffer, 0);
+	if (outfile.fail()) Error("Can't write the SVG file");
+}
+
+/*
+ * Appends an integer or a real number to the SVG buffer without creating a string for it.
+ */
+void svgPutInt(string & buffer, int num) {
+	char digits[MAX_INTEGER_CHARS];
+	buffer.append(digits, FormatInteger(num, digits, MAX_INTEGER_CHARS));
+}
+
+void svgPutReal(string & buffer, double num) {
+	char digits[MAX_REAL_CHARS];
+	buffer.append(digits, FormatReal(num, digits, MAX_REAL_CHARS));
+}
+
+/*
+ * Writes out and empties the SVG buffer if it holds at least limit characters.
+ */
+void svgFlush(ofstream & outfile, string & buffer, int limit) {
+	if ((int) buffer.length() < limit) return;
+	outfile.write(buffer.data(), buffer.length());
+	buffer.clear();
+}
+
 /**************************************/
 /* Print Functions (For Testing Only) */
 /**************************************/